@@ -1,3 +1,14 @@
 include_guard(GLOBAL)
 
 option(BUILD_SHARED_LIBS "Build shared libraries" ON)
+
+# The vectorized code paths are selected at compile time, AVX2 requires a
+# CPU that supports it (x86-64 with AVX2 and FMA, Haswell or later)
+option(IMGS_ENABLE_AVX2 "Compile the AVX2 code paths" OFF)
+if (IMGS_ENABLE_AVX2)
+  if (MSVC)
+    add_compile_options(/arch:AVX2)
+  else()
+    add_compile_options(-mavx2 -mfma)
+  endif()
+endif()
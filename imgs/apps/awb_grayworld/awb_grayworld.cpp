@@ -1,5 +1,7 @@
 #include <ctime>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
@@ -18,6 +20,11 @@ int main(int argc, char* argv[]) {
   string dst_filename = "";
   double scale = 1.1;
   int max_value = 255;
+  int stride = 4;
+  int statistics_stride = 1;
+  string estimator = "grayworld";
+  double p = 6;
+  double percentile = 99;
 
   po::options_description options("Options");
   options.add_options()("help,h", "display this message")(
@@ -28,7 +35,21 @@ int main(int argc, char* argv[]) {
                               po::value<double>(&scale),
                               "chrominance shift multiplier [default is 1.1]")(
       "max-value,m", po::value<int>(&max_value),
-      "maximum value [default is 255]");
+      "maximum value [default is 255]")(
+      "stride,s", po::value<int>(&stride),
+      "grayworld (L*a*b*) statistics subsampling stride [default is 4]")(
+      "statistics-stride", po::value<int>(&statistics_stride),
+      "shared statistics subsampling stride of the other estimators "
+      "[default is 1]")(
+      "estimator,e", po::value<string>(&estimator),
+      "illuminant estimator grayworld | rgb-gray-world | white-patch | "
+      "shades-of-gray | gray-edge | percentile | all (grayworld shifts the "
+      "L*a*b* chrominance in passes of its own, the others share a single "
+      "statistics pass) [default is grayworld]")(
+      "norm,p", po::value<double>(&p),
+      "shades of gray and gray edge Minkowski norm [default is 6]")(
+      "percentile", po::value<double>(&percentile),
+      "percentile estimator percentile [default is 99]");
 
   po::positional_options_description positional_options;
   positional_options.add("source-filename", -1);
@@ -47,6 +68,24 @@ int main(int argc, char* argv[]) {
     return EXIT_SUCCESS;
   }
 
+  // Estimators computed from the shared statistics pass
+  const vector<pair<string, ipcv::AwbEstimator>> estimators = {
+      {"rgb-gray-world", ipcv::AwbEstimator::gray_world},
+      {"white-patch", ipcv::AwbEstimator::white_patch},
+      {"shades-of-gray", ipcv::AwbEstimator::shades_of_gray},
+      {"gray-edge", ipcv::AwbEstimator::gray_edge},
+      {"percentile", ipcv::AwbEstimator::percentile}};
+
+  bool known = estimator == "grayworld" || estimator == "all";
+  for (const auto& entry : estimators) {
+    known = known || estimator == entry.first;
+  }
+  if (!known) {
+    cerr << "*** ERROR *** ";
+    cerr << "Unknown estimator: " << estimator << endl;
+    return EXIT_FAILURE;
+  }
+
   if (!boost::filesystem::exists(src_filename)) {
     cerr << "Provided source file does not exists" << endl;
     return EXIT_FAILURE;
@@ -60,12 +99,40 @@ int main(int argc, char* argv[]) {
     cout << "Channels: " << src.channels() << endl;
     cout << "Chrominance shift multiplier: " << scale << endl;
     cout << "Maximum value: " << max_value << endl;
+    cout << "Gray world statistics subsampling stride: " << stride << endl;
+    cout << "Shared statistics subsampling stride: " << statistics_stride
+         << endl;
+    cout << "Estimator: " << estimator << endl;
     cout << "Destination filename: " << dst_filename << endl;
   }
 
   clock_t startTime = clock();
 
-  cv::Mat dst = ipcv::GrayworldAwb(src, scale, max_value);
+  vector<pair<string, cv::Mat>> balanced;
+  // The L*a*b* gray world reads the source on its own (a subsampled pass
+  // for the statistics and a full pass for the correction)
+  if (estimator == "grayworld" || estimator == "all") {
+    balanced.push_back(
+        {"grayworld", ipcv::GrayworldAwb(src, scale, max_value, stride)});
+  }
+  if (estimator != "grayworld") {
+    // A single read of the source accumulates the statistics of all other
+    // estimators
+    ipcv::AwbStatistics statistics =
+        ipcv::AccumulateAwbStatistics(src, max_value, p, statistics_stride);
+    for (const auto& entry : estimators) {
+      if (estimator != "all" && estimator != entry.first) {
+        continue;
+      }
+      cv::Vec3d illuminant =
+          ipcv::EstimateIlluminant(statistics, entry.second, percentile);
+      if (verbose) {
+        cout << "Illuminant [" << entry.first << "]: " << illuminant << endl;
+      }
+      balanced.push_back(
+          {entry.first, ipcv::WhiteBalance(src, illuminant, max_value)});
+    }
+  }
 
   clock_t endTime = clock();
 
@@ -77,10 +144,23 @@ int main(int argc, char* argv[]) {
 
   if (dst_filename.empty()) {
     cv::imshow(src_filename, src);
-    cv::imshow(src_filename + " [Balanced]", dst);
+    for (const auto& entry : balanced) {
+      cv::imshow(src_filename + " [Balanced, " + entry.first + "]",
+                 entry.second);
+    }
     cv::waitKey(0);
+  } else if (balanced.size() == 1) {
+    cv::imwrite(dst_filename, balanced[0].second);
   } else {
-    cv::imwrite(dst_filename, dst);
+    // Every estimator is written next to the destination filename, with
+    // the estimator appended to its stem
+    boost::filesystem::path path(dst_filename);
+    for (const auto& entry : balanced) {
+      boost::filesystem::path filename =
+          path.parent_path() / (path.stem().string() + "_" + entry.first +
+                                path.extension().string());
+      cv::imwrite(filename.string(), entry.second);
+    }
   }
 
   return EXIT_SUCCESS;
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/highgui.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "imgs/ipcv/utils/Utils.h"
+
+using namespace std;
+
+// Absolute differences between delta E (2000) values and the double
+// precision reference formula evaluated pixel by pixel on a pair of L*a*b*
+// images
+struct Errors {
+  double max = 0;
+  double sum = 0;
+  int exceeded = 0;
+};
+
+Errors Compare(const cv::Mat& dE, const cv::Mat& lab1, const cv::Mat& lab2,
+               const double bound) {
+  Errors errors;
+  for (int r = 0; r < dE.rows; r++) {
+    for (int c = 0; c < dE.cols; c++) {
+      double reference = ipcv::DeltaE2000(lab1.at<cv::Vec3f>(r, c),
+                                          lab2.at<cv::Vec3f>(r, c));
+      double error = fabs(dE.at<float>(r, c) - reference);
+      errors.max = max(errors.max, error);
+      errors.sum += error;
+      errors.exceeded += error > bound;
+    }
+  }
+  return errors;
+}
+
+// Report the errors of a check, only the hue discontinuity of the formula
+// may exceed the bound
+bool Report(const string& check, const Errors& errors, const double bound,
+            const size_t total) {
+  cout << "  " << check << endl;
+  cout << "    Error [max] = " << errors.max << endl;
+  cout << "    Error [avg] = " << errors.sum / total << endl;
+  cout << "    Pixels above " << bound << " = " << errors.exceeded << endl;
+  return errors.exceeded <= static_cast<int>(total * 1e-5);
+}
+
+// Accuracy of delta E (2000), both of the vectorized formula alone and end
+// to end (including the L*a*b* LUT conversion) against the double
+// precision reference formula
+int main() {
+  const double bound = 1e-3;
+  // Every L*a*b* value of the 65 x 65 x 65 LUT lies within 0.15 delta E
+  // (1976) of cv::cvtColor (see LabLut.h).  The colors of a pair of
+  // similar images fall into the same LUT cells, so that their conversion
+  // errors largely cancel and the delta E of a pair moves by no more than
+  // that (arbitrary pairs may move further, see DeltaE.h).
+  const int grid = 65;
+  const double conversion_bound = 0.15 + bound;
+  const string directory = "../data/images/";
+
+  cv::Mat lenna = cv::imread(directory + "misc/lenna_color.ppm",
+                             cv::IMREAD_COLOR);
+  cv::Mat lenna_blur;
+  cv::GaussianBlur(lenna, lenna_blur, cv::Size(7, 7), 2);
+  vector<pair<string, pair<cv::Mat, cv::Mat>>> pairs = {
+      {"awb/clayton_missouri.ppm vs awb/clayton_missouri_awb.ppm",
+       {cv::imread(directory + "awb/clayton_missouri.ppm", cv::IMREAD_COLOR),
+        cv::imread(directory + "awb/clayton_missouri_awb.ppm",
+                   cv::IMREAD_COLOR)}},
+      {"misc/lenna_color.ppm vs blurred", {lenna, lenna_blur}}};
+
+  bool passed = true;
+  for (const auto& p : pairs) {
+    const cv::Mat& src1 = p.second.first;
+    const cv::Mat& src2 = p.second.second;
+    cout << p.first << endl;
+    if (src1.empty() || src2.empty()) {
+      cerr << "*** ERROR *** ";
+      cerr << "Images could not be read" << endl;
+      return EXIT_FAILURE;
+    }
+
+    cv::Mat dE;
+    clock_t startTime = clock();
+    double deltae =
+        ipcv::DeltaE(src1, src2, dE, 255, 2000, "graphic_arts", grid);
+    clock_t endTime = clock();
+
+    // Same L*a*b* values as DeltaE, so that only the formula is compared
+    const ipcv::LabLut lut(src1.depth(), 255, grid);
+    cv::Mat lab1;
+    lut.Convert(src1, lab1);
+    cv::Mat lab2;
+    lut.Convert(src2, lab2);
+    Errors formula = Compare(dE, lab1, lab2, bound);
+
+    // Exact L*a*b* values, so that the conversion error is included
+    cv::Mat src1_normalized;
+    src1.convertTo(src1_normalized, CV_32F, 1.0 / 255);
+    cv::Mat src2_normalized;
+    src2.convertTo(src2_normalized, CV_32F, 1.0 / 255);
+    cv::cvtColor(src1_normalized, lab1, cv::COLOR_BGR2Lab);
+    cv::cvtColor(src2_normalized, lab2, cv::COLOR_BGR2Lab);
+    Errors end_to_end = Compare(dE, lab1, lab2, conversion_bound);
+
+    cout << "  dE (2000) [avg] = " << deltae << endl;
+    cout << "  Elapsed time: "
+         << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
+         << " [s]" << endl;
+    passed = Report("Formula (LUT L*a*b*)", formula, bound, dE.total()) &&
+             passed;
+    passed = Report("End to end (cv::cvtColor L*a*b*)", end_to_end,
+                    conversion_bound, dE.total()) &&
+             passed;
+  }
+
+  cout << (passed ? "PASSED" : "FAILED") << endl;
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
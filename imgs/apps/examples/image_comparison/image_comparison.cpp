@@ -1,5 +1,18 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include <boost/program_options.hpp>
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
@@ -8,7 +21,10 @@
 
 using namespace std;
 
-int main() {
+namespace po = boost::program_options;
+
+// Single pair demonstration (blurred copy of a sample image)
+int CompareSample() {
   string filename = "../data/images/misc/lenna_color.ppm";
 
   cv::Mat src = cv::imread(filename, cv::IMREAD_UNCHANGED);
@@ -31,6 +47,12 @@ int main() {
   double rmse = ipcv::Rmse(src, blur);
   cout << "RMSE = " << rmse << endl;
 
+  double ssim = ipcv::Ssim(src, blur, 255);
+  cout << "SSIM = " << ssim << endl;
+
+  double msssim = ipcv::MsSsim(src, blur, 255);
+  cout << "MS-SSIM = " << msssim << endl;
+
   cv::Mat dE;
   int standard = 2000;
   string application = "graphic_arts";
@@ -49,3 +71,384 @@ int main() {
 
   return EXIT_SUCCESS;
 }
+
+// Blocking FIFO queue of bounded capacity, Pop returns false once the queue
+// is closed and drained
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(const size_t capacity) : capacity_(capacity) {}
+
+  void Push(T item) {
+    unique_lock<mutex> lock(mutex_);
+    not_full_.wait(lock, [&] { return items_.size() < capacity_; });
+    items_.push(move(item));
+    not_empty_.notify_one();
+  }
+
+  bool Pop(T& item) {
+    unique_lock<mutex> lock(mutex_);
+    not_empty_.wait(lock, [&] { return !items_.empty() || closed_; });
+    if (items_.empty()) {
+      return false;
+    }
+    item = move(items_.front());
+    items_.pop();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void Close() {
+    lock_guard<mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+ private:
+  size_t capacity_;
+  bool closed_ = false;
+  queue<T> items_;
+  mutex mutex_;
+  condition_variable not_full_;
+  condition_variable not_empty_;
+};
+
+using Clock = chrono::steady_clock;
+
+struct Pair {
+  string reference;
+  string test;
+};
+
+struct DecodedPair {
+  size_t index;
+  Clock::time_point start;
+  cv::Mat reference;
+  cv::Mat test;
+};
+
+struct PairResult {
+  string status = "not compared";
+  ipcv::ImageMetrics metrics;
+  double ssim = NAN;
+  double msssim = NAN;
+  double latency = 0;
+};
+
+struct BatchOptions {
+  bool ssim = false;
+  bool msssim = false;
+  int standard = 2000;
+  int io_threads = 2;
+  int workers = 1;
+  int prefetch = 16;
+};
+
+// Pairs of filenames, one pair per line separated by a comma or white
+// space (empty lines and lines starting with # are ignored)
+bool ReadManifest(const string& filename, vector<Pair>& pairs) {
+  ifstream manifest(filename);
+  if (!manifest) {
+    return false;
+  }
+  string line;
+  while (getline(manifest, line)) {
+    replace(line.begin(), line.end(), ',', ' ');
+    istringstream fields(line);
+    Pair pair;
+    if (!(fields >> pair.reference) || pair.reference[0] == '#') {
+      continue;
+    }
+    if (!(fields >> pair.test)) {
+      return false;
+    }
+    pairs.push_back(pair);
+  }
+  return true;
+}
+
+void ComparePair(const DecodedPair& pair, const BatchOptions& options,
+                 PairResult& result) {
+  const cv::Mat& reference = pair.reference;
+  const cv::Mat& test = pair.test;
+  if (reference.empty() || test.empty()) {
+    result.status = "unreadable";
+    return;
+  }
+  if (reference.size() != test.size() || reference.type() != test.type()) {
+    result.status = "mismatched";
+    return;
+  }
+
+  // The maximum value is only implied by integer depths
+  if (reference.depth() != CV_8U && reference.depth() != CV_16U) {
+    result.status = "unsupported";
+    return;
+  }
+  const int max_value = reference.depth() == CV_16U ? 65535 : 255;
+  const int standard = reference.channels() == 3 ? options.standard : 0;
+  result.metrics = ipcv::CompareImages(reference, test, max_value, standard);
+
+  // SSIM requires a full window, MS-SSIM one at the coarsest of 5 scales
+  const int size = min(reference.rows, reference.cols);
+  if (options.ssim && size >= 11) {
+    result.ssim = ipcv::Ssim(reference, test, max_value);
+  }
+  if (options.msssim && size >= 11 * 16) {
+    result.msssim = ipcv::MsSsim(reference, test, max_value);
+  }
+  result.status = "ok";
+}
+
+// Decode the pairs on I/O threads into a bounded queue that is drained by
+// the worker threads (which compute the metrics)
+void CompareBatch(const vector<Pair>& pairs, const BatchOptions& options,
+                  vector<PairResult>& results) {
+  results.assign(pairs.size(), PairResult());
+  BoundedQueue<DecodedPair> decoded(options.prefetch);
+
+  atomic<size_t> next(0);
+  vector<thread> readers;
+  for (int t = 0; t < options.io_threads; t++) {
+    readers.emplace_back([&] {
+      for (size_t i = next++; i < pairs.size(); i = next++) {
+        DecodedPair pair;
+        pair.index = i;
+        pair.start = Clock::now();
+        pair.reference = cv::imread(pairs[i].reference, cv::IMREAD_UNCHANGED);
+        pair.test = cv::imread(pairs[i].test, cv::IMREAD_UNCHANGED);
+        decoded.Push(move(pair));
+      }
+    });
+  }
+
+  vector<thread> workers;
+  for (int t = 0; t < options.workers; t++) {
+    workers.emplace_back([&] {
+      DecodedPair pair;
+      while (decoded.Pop(pair)) {
+        PairResult& result = results[pair.index];
+        ComparePair(pair, options, result);
+        result.latency =
+            chrono::duration<double>(Clock::now() - pair.start).count();
+      }
+    });
+  }
+
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  decoded.Close();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+string Number(const double value) {
+  if (!isfinite(value)) {
+    return isnan(value) ? "" : (value > 0 ? "inf" : "-inf");
+  }
+  ostringstream s;
+  s.precision(10);
+  s << value;
+  return s.str();
+}
+
+// Quoted string, quotes are escaped by doubling them (CSV) or with a
+// backslash, as are backslashes (JSON)
+string Quoted(const string& text, const bool json) {
+  string quoted = "\"";
+  for (char c : text) {
+    if (c == '"') {
+      quoted += json ? '\\' : '"';
+    } else if (c == '\\' && json) {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+// JSON has no representation of infinity or NaN, those become null
+string JsonNumber(const double value) {
+  return isfinite(value) ? Number(value) : "null";
+}
+
+void WriteSummary(ostream& out, const bool json, const vector<Pair>& pairs,
+                  const vector<PairResult>& results,
+                  const BatchOptions& options) {
+  if (json) {
+    out << "[" << endl;
+  } else {
+    out << "reference,test,status,psnr,rmse,max_error,delta_e,ssim,ms_ssim,"
+        << "latency_ms" << endl;
+  }
+  for (size_t i = 0; i < pairs.size(); i++) {
+    const PairResult& r = results[i];
+    bool ok = r.status == "ok";
+    double delta_e = ok && options.standard ? r.metrics.delta_e : NAN;
+    double psnr = ok ? r.metrics.psnr : NAN;
+    double rmse = ok ? r.metrics.rmse : NAN;
+    double max_error = ok ? r.metrics.max_error : NAN;
+    if (json) {
+      out << "  {\"reference\": " << Quoted(pairs[i].reference, true)
+          << ", \"test\": " << Quoted(pairs[i].test, true)
+          << ", \"status\": " << Quoted(r.status, true)
+          << ", \"psnr\": " << JsonNumber(psnr)
+          << ", \"rmse\": " << JsonNumber(rmse)
+          << ", \"max_error\": " << JsonNumber(max_error)
+          << ", \"delta_e\": " << JsonNumber(delta_e)
+          << ", \"ssim\": " << JsonNumber(r.ssim)
+          << ", \"ms_ssim\": " << JsonNumber(r.msssim)
+          << ", \"latency_ms\": " << JsonNumber(r.latency * 1000) << "}"
+          << (i + 1 < pairs.size() ? "," : "") << endl;
+    } else {
+      out << Quoted(pairs[i].reference, false) << ","
+          << Quoted(pairs[i].test, false) << ","
+          << r.status << "," << Number(psnr) << "," << Number(rmse) << ","
+          << Number(max_error) << "," << Number(delta_e) << ","
+          << Number(r.ssim) << "," << Number(r.msssim) << ","
+          << Number(r.latency * 1000) << endl;
+    }
+  }
+  if (json) {
+    out << "]" << endl;
+  }
+}
+
+// Nearest-rank percentile of sorted values
+double Percentile(const vector<double>& sorted, const double p) {
+  size_t rank = static_cast<size_t>(ceil(p / 100 * sorted.size()));
+  return sorted[min(max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+}
+
+int main(int argc, char* argv[]) {
+  string manifest_filename = "";
+  string summary_filename = "";
+  string metrics = "psnr,rmse,deltae";
+  BatchOptions options;
+  options.workers = max(1u, thread::hardware_concurrency());
+
+  po::options_description po_options("Options");
+  po_options.add_options()("help,h", "display this message")(
+      "manifest,m", po::value<string>(&manifest_filename),
+      "manifest of image pairs, one pair of filenames per line separated "
+      "by a comma or white space [default compares a blurred sample image]")(
+      "summary,o", po::value<string>(&summary_filename),
+      "summary filename, JSON for a .json extension, CSV otherwise "
+      "[default is CSV to the standard output]")(
+      "metrics", po::value<string>(&metrics),
+      "metrics to compute, comma separated list of psnr | rmse | deltae | "
+      "ssim | msssim (PSNR, RMSE and the maximum error come from the same "
+      "pass) [default is psnr,rmse,deltae]")(
+      "standard,s", po::value<int>(&options.standard),
+      "delta E standard 1976 | 1994 | 2000 [default is 2000]")(
+      "io-threads", po::value<int>(&options.io_threads),
+      "image decoding threads [default is 2]")(
+      "workers,w", po::value<int>(&options.workers),
+      "metric computation threads (with more than one worker OpenCV's own "
+      "threads are turned off, every pair is compared on a single thread) "
+      "[default is the number of cores]")(
+      "prefetch,p", po::value<int>(&options.prefetch),
+      "maximum number of decoded pairs waiting for a worker [default is "
+      "16]");
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, po_options), vm);
+  po::notify(vm);
+
+  if (vm.count("help")) {
+    cout << "Usage: " << argv[0] << " [options]" << endl;
+    cout << po_options << endl;
+    return EXIT_SUCCESS;
+  }
+
+  if (manifest_filename.empty()) {
+    return CompareSample();
+  }
+
+  bool deltae = false;
+  istringstream metric_list(metrics);
+  string metric;
+  while (getline(metric_list, metric, ',')) {
+    if (metric == "ssim") {
+      options.ssim = true;
+    } else if (metric == "msssim") {
+      options.msssim = true;
+    } else if (metric == "deltae") {
+      deltae = true;
+    } else if (metric != "psnr" && metric != "rmse") {
+      cerr << "*** ERROR *** ";
+      cerr << "Provided metric is not supported: " << metric << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if (!deltae) {
+    options.standard = 0;
+  } else if (options.standard != 1976 && options.standard != 1994 &&
+             options.standard != 2000) {
+    cerr << "*** ERROR *** ";
+    cerr << "Provided delta E standard is not supported: "
+         << options.standard << endl;
+    return EXIT_FAILURE;
+  }
+  if (options.io_threads < 1 || options.workers < 1 || options.prefetch < 1) {
+    cerr << "*** ERROR *** ";
+    cerr << "Thread counts and prefetch depth must be positive" << endl;
+    return EXIT_FAILURE;
+  }
+
+  vector<Pair> pairs;
+  if (!ReadManifest(manifest_filename, pairs)) {
+    cerr << "*** ERROR *** ";
+    cerr << "Manifest could not be read: " << manifest_filename << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The metrics run their own cv::parallel_for_, which would nest a pool
+  // of threads per core within every worker (and distort the latencies)
+  if (options.workers > 1) {
+    cv::setNumThreads(1);
+  }
+
+  Clock::time_point startTime = Clock::now();
+  vector<PairResult> results;
+  CompareBatch(pairs, options, results);
+  double elapsed = chrono::duration<double>(Clock::now() - startTime).count();
+
+  bool json = summary_filename.size() >= 5 &&
+              summary_filename.compare(summary_filename.size() - 5, 5,
+                                       ".json") == 0;
+  if (summary_filename.empty()) {
+    WriteSummary(cout, json, pairs, results, options);
+  } else {
+    ofstream summary(summary_filename);
+    if (!summary) {
+      cerr << "*** ERROR *** ";
+      cerr << "Summary could not be written: " << summary_filename << endl;
+      return EXIT_FAILURE;
+    }
+    WriteSummary(summary, json, pairs, results, options);
+  }
+
+  // Throughput and latency (decode start to metrics done) percentiles
+  vector<double> latencies;
+  int failures = 0;
+  for (const auto& result : results) {
+    latencies.push_back(result.latency * 1000);
+    failures += result.status != "ok";
+  }
+  sort(latencies.begin(), latencies.end());
+  cerr << "Pairs: " << pairs.size() << " (" << failures << " failed)"
+       << endl;
+  cerr << "Elapsed time: " << elapsed << " [s]" << endl;
+  if (!latencies.empty()) {
+    cerr << "Throughput: " << pairs.size() / elapsed << " [pairs/s]" << endl;
+    cerr << "Latency p50 / p90 / p99 / max: " << Percentile(latencies, 50)
+         << " / " << Percentile(latencies, 90) << " / "
+         << Percentile(latencies, 99) << " / " << latencies.back() << " [ms]"
+         << endl;
+  }
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
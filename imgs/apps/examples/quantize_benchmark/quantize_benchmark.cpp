@@ -0,0 +1,190 @@
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/highgui.hpp>
+
+#include "imgs/ipcv/quantize/Quantize.h"
+
+using namespace std;
+
+// Previous uniform quantization (per-pixel cv::Mat::at access)
+void LegacyUniform(const cv::Mat& src, const int quantization_levels,
+                   cv::Mat& dst) {
+  dst.create(src.size(), src.type());
+  int binSize = 255 / quantization_levels;
+  for (int i = 0; i < src.rows; i++) {
+    for (int j = 0; j < src.cols; j++) {
+      auto value = src.at<cv::Vec3b>(i, j);
+      for (int b = 0; b < 3; b++) {
+        dst.at<cv::Vec3b>(i, j)[b] = value[b] / binSize;
+      }
+    }
+  }
+}
+
+// Previous IGS quantization, copied verbatim from the implementation it
+// replaced.  The sum is split at 8 - log2(levels) bits, and each branch
+// then reparses both halves through a fixed-width bitset (so only 16
+// levels keeps and carries the intended bits), sums above 255 wrap and
+// the carry is not reset between rows.
+void LegacyIgs(const cv::Mat& src, const int quantization_levels, cv::Mat& dst) {
+    
+    dst.create(src.size(), CV_8UC3);
+    // Find the number of quantized bit levels by calculating the log base 2 floor
+    // ex: log2(9) = 3
+    const int bitLevels = log2(quantization_levels);
+    
+    vector<string> upperBits(3);
+    vector<string> lowerBits(3);
+    vector<string> bits(3);
+    // Instantiate the first upper and lower bit values to be 0
+    vector<long> upperBitsVal(3, 0);
+    vector<long> lowerBitsVal(3, 0);
+    vector<long> newVal(3);
+    for(int i = 0; i < src.rows; i++){
+        for(int j = 0; j < src.cols; j++){
+            // Grab the pixel(s) value at every location in the image
+            auto value = src.at<cv::Vec3b>(i,j);
+            // Add the lower bit value of the previous pixel
+            newVal[0] = value[0]+lowerBitsVal[0];
+            newVal[1] = value[1]+lowerBitsVal[1];
+            newVal[2] = value[2]+lowerBitsVal[2];
+            // Convert the current pixel value to binary
+            bits[0] = bitset<8>(newVal[0]).to_string();
+            bits[1] = bitset<8>(newVal[1]).to_string();
+            bits[2] = bitset<8>(newVal[2]).to_string();
+            // Segment the new current bit into it's upper and lower portions
+            upperBits[0] = bits[0].substr(0,8-bitLevels);
+            upperBits[1] = bits[1].substr(0,8-bitLevels);
+            upperBits[2] = bits[2].substr(0,8-bitLevels);
+            lowerBits[0] = bits[0].substr(8-bitLevels,string::npos);
+            lowerBits[1] = bits[1].substr(8-bitLevels,string::npos);
+            lowerBits[2] = bits[2].substr(8-bitLevels,string::npos);
+            // Perform the quantization by assigning the upper bits to the destination image and sending the lower bits to the next pixel
+            if(bitLevels == 7){
+                dst.at<cv::Vec3b>(i,j)[0] = bitset<7>(upperBits[0]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[1] = bitset<7>(upperBits[1]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[2] = bitset<7>(upperBits[2]).to_ulong();
+                lowerBitsVal[0] = bitset<1>(lowerBits[0]).to_ulong();
+                lowerBitsVal[1] = bitset<1>(lowerBits[1]).to_ulong();
+                lowerBitsVal[2] = bitset<1>(lowerBits[2]).to_ulong();
+            }
+            else if (bitLevels == 6){
+                dst.at<cv::Vec3b>(i,j)[0] = bitset<6>(upperBits[0]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[1] = bitset<6>(upperBits[1]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[2] = bitset<6>(upperBits[2]).to_ulong();
+                lowerBitsVal[0] = bitset<2>(lowerBits[0]).to_ulong();
+                lowerBitsVal[1] = bitset<2>(lowerBits[1]).to_ulong();
+                lowerBitsVal[2] = bitset<2>(lowerBits[2]).to_ulong();
+            }
+            else if (bitLevels == 5){
+                dst.at<cv::Vec3b>(i,j)[0] = bitset<5>(upperBits[0]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[1] = bitset<5>(upperBits[1]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[2] = bitset<5>(upperBits[2]).to_ulong();
+                lowerBitsVal[0] = bitset<3>(lowerBits[0]).to_ulong();
+                lowerBitsVal[1] = bitset<3>(lowerBits[1]).to_ulong();
+                lowerBitsVal[2] = bitset<3>(lowerBits[2]).to_ulong();
+            }
+            else if (bitLevels == 4){
+                dst.at<cv::Vec3b>(i,j)[0] = bitset<4>(upperBits[0]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[1] = bitset<4>(upperBits[1]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[2] = bitset<4>(upperBits[2]).to_ulong();
+                lowerBitsVal[0] = bitset<4>(lowerBits[0]).to_ulong();
+                lowerBitsVal[1] = bitset<4>(lowerBits[1]).to_ulong();
+                lowerBitsVal[2] = bitset<4>(lowerBits[2]).to_ulong();
+            }
+            else if (bitLevels == 3){
+                dst.at<cv::Vec3b>(i,j)[0] = bitset<3>(upperBits[0]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[1] = bitset<3>(upperBits[1]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[2] = bitset<3>(upperBits[2]).to_ulong();
+                lowerBitsVal[0] = bitset<5>(lowerBits[0]).to_ulong();
+                lowerBitsVal[1] = bitset<5>(lowerBits[1]).to_ulong();
+                lowerBitsVal[2] = bitset<5>(lowerBits[2]).to_ulong();
+            }
+            else if (bitLevels == 2){
+                dst.at<cv::Vec3b>(i,j)[0] = bitset<2>(upperBits[0]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[1] = bitset<2>(upperBits[1]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[2] = bitset<2>(upperBits[2]).to_ulong();
+                lowerBitsVal[0] = bitset<2>(lowerBits[0]).to_ulong();
+                lowerBitsVal[1] = bitset<2>(lowerBits[1]).to_ulong();
+                lowerBitsVal[2] = bitset<2>(lowerBits[2]).to_ulong();
+            }
+            else if (bitLevels == 1){
+                dst.at<cv::Vec3b>(i,j)[0] = bitset<1>(upperBits[0]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[1] = bitset<1>(upperBits[1]).to_ulong();
+                dst.at<cv::Vec3b>(i,j)[2] = bitset<1>(upperBits[2]).to_ulong();
+                lowerBitsVal[0] = bitset<7>(lowerBits[0]).to_ulong();
+                lowerBitsVal[1] = bitset<7>(lowerBits[1]).to_ulong();
+                lowerBitsVal[2] = bitset<7>(lowerBits[2]).to_ulong();
+            }
+        }
+    }
+}
+
+// Average elapsed (wall clock) time [s] of a number of repetitions of the
+// provided function, the current implementations run in parallel so that
+// the processor time of clock() would add up the time of all threads
+double Time(const function<void()>& f, const int repetitions) {
+  chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+  for (int n = 0; n < repetitions; n++) {
+    f();
+  }
+  chrono::steady_clock::time_point endTime = chrono::steady_clock::now();
+  return chrono::duration<double>(endTime - startTime).count() / repetitions;
+}
+
+// Number of differing values between two images
+int Differences(const cv::Mat& a, const cv::Mat& b) {
+  cv::Mat different;
+  cv::compare(a, b, different, cv::CMP_NE);
+  return cv::countNonZero(different.reshape(1));
+}
+
+int main() {
+  string filename = "../data/images/misc/lenna_color.ppm";
+  const int repetitions = 5;
+
+  cv::Mat src = cv::imread(filename, cv::IMREAD_COLOR);
+  cout << "Image ..." << endl;
+  cout << filename << endl;
+  cout << "Dimensions: " << src.rows << "x" << src.cols << endl;
+  cout << endl;
+
+  for (int levels : {2, 8, 16, 64}) {
+    cv::Mat legacy;
+    cv::Mat current;
+
+    double legacy_time = Time([&] { LegacyUniform(src, levels, legacy); },
+                              repetitions);
+    double current_time = Time(
+        [&] {
+          ipcv::Quantize(src, levels, ipcv::QuantizationType::uniform,
+                         current);
+        },
+        repetitions);
+    cout << "Uniform (" << levels << " levels): " << legacy_time << " [s] -> "
+         << current_time << " [s], " << legacy_time / current_time
+         << "x, differing values: " << Differences(legacy, current) << endl;
+
+    // The previous IGS split most bit depths incorrectly (see LegacyIgs),
+    // so the IGS results are expected to differ
+    legacy_time =
+        Time([&] { LegacyIgs(src, levels, legacy); }, repetitions);
+    current_time = Time(
+        [&] {
+          ipcv::Quantize(src, levels, ipcv::QuantizationType::igs, current);
+        },
+        repetitions);
+    cout << "IGS (" << levels << " levels): " << legacy_time << " [s] -> "
+         << current_time << " [s], " << legacy_time / current_time
+         << "x, differing values: " << Differences(legacy, current) << endl;
+  }
+
+  return EXIT_SUCCESS;
+}
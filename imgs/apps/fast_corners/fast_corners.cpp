@@ -73,29 +73,20 @@ int main(int argc, char* argv[]) {
 
   bool status = false;
   cv::Mat dst;
-  status = ipcv::Fast(src, dst, difference_threshold, contiguous_threshold,
-                      nonmaximal_suppression);
+  vector<cv::KeyPoint> keypoints;
+  status = ipcv::Fast(src, dst, keypoints, difference_threshold,
+                      contiguous_threshold, nonmaximal_suppression);
 
   clock_t endTime = clock();
 
-    // Find the corner coordinates using the returned corner response image
-    int rows = dst.rows;
-    int cols = dst.cols;
-    std::vector<cv::Point> cornerCoors;
-    for (int m = 0; m<rows; m++){
-        const uchar* dst_ptr = dst.ptr<uchar>(m);
-        for (int n = 0; n<cols; n++){
-            if(dst_ptr[n] > 0) cornerCoors.push_back(cv::Point(n,m));
-        }
-    }
-
   if (verbose) {
     cout << "Elapsed time: "
          << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
          << " [s]" << endl;
-      cout << "Corner Points:" << endl;
-      for (int i = 0; i < cornerCoors.size(); i++) {
-          cout << cornerCoors[i] << endl;
+      cout << "Corner Points: " << keypoints.size() << endl;
+      for (const auto& keypoint : keypoints) {
+          cout << cv::Point(keypoint.pt) << " score = " << keypoint.response
+               << endl;
       }
   }
 
@@ -17,6 +17,10 @@ int main(int argc, char* argv[]) {
   string src_filename = "";
   float sigma = 1;
   float k = 0.04;
+  int max_corners = 500;
+  float min_distance = 10;
+  float quality_level = 0.01;
+  bool shi_tomasi = false;
 
   po::options_description options("Options");
   options.add_options()("help,h", "display this message")(
@@ -25,7 +29,16 @@ int main(int argc, char* argv[]) {
       "sigma,s", po::value<float>(&sigma),
       "standard deviation for blur [default is 1]")(
       "parameter,k", po::value<float>(&k),
-      "free parameter for Harris response [default is 0.04]");
+      "free parameter for Harris response [default is 0.04]")(
+      "max-corners,n", po::value<int>(&max_corners),
+      "maximum number of corners [default is 500]")(
+      "min-distance,m", po::value<float>(&min_distance),
+      "minimum distance between corners [default is 10]")(
+      "quality-level,q", po::value<float>(&quality_level),
+      "minimum response relative to the strongest [default is 0.01]")(
+      "shi-tomasi,t", po::bool_switch(&shi_tomasi),
+      "use the Shi-Tomasi (minimum eigenvalue) response [default is "
+      "Harris]");
 
   po::positional_options_description positional_options;
   positional_options.add("source-filename", -1);
@@ -58,33 +71,35 @@ int main(int argc, char* argv[]) {
     cout << "Channels: " << src.channels() << endl;
     cout << "Sigma: " << sigma << endl;
     cout << "k: " << k << endl;
+    cout << "Maximum corners: " << max_corners << endl;
+    cout << "Minimum distance: " << min_distance << endl;
+    cout << "Quality level: " << quality_level << endl;
+    cout << "Measure: " << (shi_tomasi ? "Shi-Tomasi" : "Harris") << endl;
   }
 
   clock_t startTime = clock();
 
   bool status = false;
   cv::Mat dst;
-  status = ipcv::Harris(src, dst, sigma, k);
+  vector<cv::KeyPoint> corners;
+  if (shi_tomasi) {
+    status = ipcv::ShiTomasi(src, dst, sigma);
+  } else {
+    status = ipcv::Harris(src, dst, sigma, k);
+  }
+  if (status) {
+    status = ipcv::ExtractCorners(dst, corners, max_corners, min_distance,
+                                  quality_level, true);
+  }
   clock_t endTime = clock();
-    
-    // Find the corner coordinates using the returned corner response image
-    int rows = dst.rows;
-    int cols = dst.cols;
-    std::vector<cv::Point> cornerCoors;
-    for (int m = 0; m<rows; m++){
-        const float* dst_ptr = dst.ptr<float>(m);
-        for (int n = 0; n<cols; n++){
-            if(dst_ptr[n] > 0) cornerCoors.push_back(cv::Point(n,m));
-        }
-    }
- 
+
   if (verbose) {
     cout << "Elapsed time: "
          << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
          << " [s]" << endl;
-      cout << "Corner Points:" << endl;
-      for (int i = 0; i < cornerCoors.size(); i++) {
-          cout << cornerCoors[i] << endl;
+      cout << "Corner Points: " << corners.size() << endl;
+      for (const auto& corner : corners) {
+          cout << corner.pt << " response = " << corner.response << endl;
       }
   }
 
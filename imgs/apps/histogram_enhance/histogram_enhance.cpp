@@ -21,6 +21,8 @@ int main(int argc, char* argv[]) {
     string enhancement_type = "linear";
     int percentage = 0;
     string tgt_filename = "";
+    double clip_limit = 2.0;
+    int tiles = 8;
     
     po::options_description options("Options");
     options.add_options()("help,h", "display this message")(
@@ -29,11 +31,15 @@ int main(int argc, char* argv[]) {
                                                                                                                                                                                                              "destination-filename,o", po::value<string>(&dst_filename),
                                                                                                                                                                                                              "destination filename")(
                                                                                                                                                                                                                                      "enhancement-type,e", po::value<string>(&enhancement_type),
-                                                                                                                                                                                                                                     "enhancement type (linear|equalize|match) [default is linear]")(
+                                                                                                                                                                                                                                     "enhancement type (linear|equalize|match|clahe) [default is linear]")(
                                                                                                                                                                                                                                                                                                      "percentage,p", po::value<int>(&percentage),
                                                                                                                                                                                                                                                                                                      "linear histogram percentage [default is 2]")(
                                                                                                                                                                                                                                                                                                                                                    "target-filename,t", po::value<string>(&tgt_filename),
-                                                                                                                                                                                                                                                                                                                                                   "target filename for matching");
+                                                                                                                                                                                                                                                                                                                                                   "target filename for matching")(
+        "clip-limit,l", po::value<double>(&clip_limit),
+        "CLAHE clip limit [default is 2]")(
+        "tiles,g", po::value<int>(&tiles),
+        "CLAHE tiles across and down the image [default is 8]");
     
     po::positional_options_description positional_options;
     positional_options.add("source-filename", -1);
@@ -53,7 +59,7 @@ int main(int argc, char* argv[]) {
     }
     
     if (enhancement_type != "linear" && enhancement_type != "equalize" &&
-        enhancement_type != "match") {
+        enhancement_type != "match" && enhancement_type != "clahe") {
         cerr << "*** ERROR *** ";
         cerr << "Provided enhancement type is not supported" << endl;
         return EXIT_FAILURE;
@@ -95,6 +101,10 @@ int main(int argc, char* argv[]) {
         if (enhancement_type == "match") {
             cout << "Target filename: " << tgt_filename << endl;
         }
+        if (enhancement_type == "clahe") {
+            cout << "Clip limit: " << clip_limit << endl;
+            cout << "Tiles: " << tiles << " x " << tiles << endl;
+        }
         cout << "Destination filename: " << dst_filename << endl;
     }
     
@@ -115,7 +125,14 @@ int main(int argc, char* argv[]) {
     }
     
     cv::Mat dst;
-    if (status) {
+    if (enhancement_type == "clahe") {
+        status = ipcv::Clahe(src, dst, clip_limit, cv::Size(tiles, tiles));
+        if (!status) {
+            cerr << "*** ERROR *** ";
+            cerr << "An error occurred while applying CLAHE" << endl;
+            return EXIT_FAILURE;
+        }
+    } else if (status) {
         ipcv::ApplyLut(src, lut, dst);
     } else {
         cerr << "*** ERROR *** ";
@@ -6,6 +6,7 @@
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 
+#include "imgs/ipcv/quantize/Dither.h"
 #include "imgs/ipcv/quantize/Quantize.h"
 
 using namespace std;
@@ -14,6 +15,7 @@ namespace po = boost::program_options;
 
 int main(int argc, char* argv[]) {
   bool verbose = false;
+  bool serpentine = false;
   int display_levels = 256;
   int quantization_levels = 8;
   string src_filename = "";
@@ -29,9 +31,14 @@ int main(int argc, char* argv[]) {
       "destination-filename,o", po::value<string>(&dst_filename),
       "destination filename")("quantization-levels,l",
                               po::value<int>(&quantization_levels),
-                              "quantization levels [default is 8]")(
+                              "quantization levels (number of colors for "
+                              "palette) [default is 8]")(
       "quantization-type,t", po::value<string>(&quantization_type_string),
-      "quantization type (uniform | igs) [default is uniform]")(
+      "quantization type (uniform | igs | floyd_steinberg | bayer | "
+      "blue_noise | palette) [default is uniform]")(
+      "serpentine,s", po::bool_switch(&serpentine),
+      "diffuse the floyd_steinberg errors in serpentine order [default is "
+      "raster order]")(
       "display-levels,d", po::value<int>(&display_levels),
       "display levels [default is 256]");
 
@@ -56,6 +63,14 @@ int main(int argc, char* argv[]) {
     quantization_type = ipcv::QuantizationType::uniform;
   } else if (quantization_type_string == "igs") {
     quantization_type = ipcv::QuantizationType::igs;
+  } else if (quantization_type_string == "floyd_steinberg") {
+    quantization_type = ipcv::QuantizationType::floyd_steinberg;
+  } else if (quantization_type_string == "bayer") {
+    quantization_type = ipcv::QuantizationType::bayer;
+  } else if (quantization_type_string == "blue_noise") {
+    quantization_type = ipcv::QuantizationType::blue_noise;
+  } else if (quantization_type_string == "palette") {
+    quantization_type = ipcv::QuantizationType::palette;
   } else {
     cerr << "Provided quantization type is not supported" << endl;
     return EXIT_FAILURE;
@@ -82,7 +97,18 @@ int main(int argc, char* argv[]) {
 
   clock_t startTime = clock();
 
-  ipcv::Quantize(src, quantization_levels, quantization_type, dst);
+  bool status;
+  if (quantization_type == ipcv::QuantizationType::floyd_steinberg &&
+      serpentine) {
+    status = ipcv::ErrorDiffusionDither(src, quantization_levels, dst, true);
+  } else {
+    status = ipcv::Quantize(src, quantization_levels, quantization_type, dst);
+  }
+  if (!status) {
+    cerr << "*** ERROR *** ";
+    cerr << "An error occurred while quantizing the image" << endl;
+    return EXIT_FAILURE;
+  }
 
   clock_t endTime = clock();
 
@@ -92,8 +118,11 @@ int main(int argc, char* argv[]) {
          << " [s]" << endl;
   }
 
-  int scale = display_levels / quantization_levels;
-  dst *= scale;
+  // Palette quantization produces colors rather than level indices
+  if (quantization_type != ipcv::QuantizationType::palette) {
+    int scale = display_levels / quantization_levels;
+    dst *= scale;
+  }
 
   if (dst_filename.empty()) {
     cv::imshow(src_filename, src);
@@ -6,6 +6,7 @@
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 
+#include "imgs/ipcv/otsus_threshold/AdaptiveOtsusThreshold.h"
 #include "imgs/ipcv/otsus_threshold/OtsusThreshold.h"
 #include "imgs/ipcv/utils/Utils.h"
 
@@ -17,13 +18,21 @@ int main(int argc, char* argv[]) {
   bool verbose = false;
   string src_filename = "";
   string dst_filename = "";
+  int radius = 0;
+  int count = 1;
 
   po::options_description options("Options");
   options.add_options()("help,h", "display this message")(
       "verbose,v", po::bool_switch(&verbose), "verbose [default is silent]")(
       "source-filename,i", po::value<string>(&src_filename), "source filename")(
       "destination-filename,o", po::value<string>(&dst_filename),
-      "destination filename");
+      "destination filename")(
+      "radius,r", po::value<int>(&radius),
+      "radius of the window for locally adaptive thresholds [default is 0, "
+      "a single global threshold]")(
+      "thresholds,t", po::value<int>(&count),
+      "number of global (multi-level) Otsu's thresholds per channel [1, 4], "
+      "the classes are mapped to evenly spaced grey levels [default is 1]");
 
   po::positional_options_description positional_options;
   positional_options.add("source-filename", -1);
@@ -54,37 +63,106 @@ int main(int argc, char* argv[]) {
     cout << "Size: " << src.size() << endl;
     cout << "Channels: " << src.channels() << endl;
     cout << "Destination filename: " << dst_filename << endl;
+    if (radius > 0) {
+      cout << "Window radius: " << radius << endl;
+    }
   }
 
-  cv::Vec3b threshold;
+  cv::Mat dst;
+  if (radius > 0) {
+    cv::Mat thresholds;
 
-  clock_t startTime = clock();
+    clock_t startTime = clock();
 
-  ipcv::OtsusThreshold(src, threshold);
+    if (!ipcv::AdaptiveOtsusThreshold(src, radius, thresholds)) {
+      cerr << "*** ERROR *** ";
+      cerr << "An error occurred while computing the thresholds" << endl;
+      return EXIT_FAILURE;
+    }
+    cv::compare(src, thresholds, dst, cv::CMP_GT);
 
-  clock_t endTime = clock();
+    clock_t endTime = clock();
 
-  if (verbose) {
-    cout << "Elapsed time: "
-         << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
-         << " [s]" << endl;
-  }
+    if (verbose) {
+      cout << "Elapsed time: "
+           << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
+           << " [s]" << endl;
+    }
 
-  if (verbose) {
-    cout << "Threshold values = ";
-    cout << threshold << endl;
+    if (dst_filename.empty()) {
+      cv::imshow(src_filename, src);
+      cv::imshow(src_filename + " [Thresholded]", dst);
+      cv::waitKey(0);
+    } else {
+      cv::imwrite(dst_filename, dst);
+    }
+
+    return EXIT_SUCCESS;
   }
 
   cv::Mat lut;
   lut.create(3, 256, CV_8UC1);
+  if (count > 1) {
+    cv::Mat thresholds;
+
+    clock_t startTime = clock();
+
+    if (!ipcv::MultilevelOtsusThreshold(src, count, thresholds)) {
+      cerr << "*** ERROR *** ";
+      cerr << "An error occurred while computing the thresholds" << endl;
+      return EXIT_FAILURE;
+    }
+
+    clock_t endTime = clock();
+
+    if (verbose) {
+      cout << "Elapsed time: "
+           << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
+           << " [s]" << endl;
+    }
+
+    if (verbose) {
+      cout << "Threshold values = ";
+      cout << thresholds << endl;
+    }
+
+    for (int b = 0; b < 3; b++) {
+      int k = 0;
+      for (int dc = 0; dc < 256; dc++) {
+        while (k < count && dc > thresholds.at<int>(b, k)) {
+          k++;
+        }
+        lut.at<uint8_t>(b, dc) = cvRound(255.0 * k / count);
+      }
+    }
+  } else {
+    cv::Vec3b threshold;
+
+    clock_t startTime = clock();
+
+    ipcv::OtsusThreshold(src, threshold);
+
+    clock_t endTime = clock();
+
+    if (verbose) {
+      cout << "Elapsed time: "
+           << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
+           << " [s]" << endl;
+    }
+
+    if (verbose) {
+      cout << "Threshold values = ";
+      cout << threshold << endl;
+    }
+
 //    threshold = {206, 206, 206};
-  for (int b = 0; b < 3; b++) {
-    for (int dc = 0; dc < 256; dc++) {
-      lut.at<uint8_t>(b, dc) = (dc <= threshold[b]) ? 0 : 255;
+    for (int b = 0; b < 3; b++) {
+      for (int dc = 0; dc < 256; dc++) {
+        lut.at<uint8_t>(b, dc) = (dc <= threshold[b]) ? 0 : 255;
+      }
     }
   }
 
-  cv::Mat dst;
   cout << lut.size() << endl;
   ipcv::ApplyLut(src, lut, dst);
     
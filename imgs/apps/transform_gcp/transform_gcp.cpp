@@ -21,6 +21,7 @@ int main(int argc, char* argv[]) {
   string map_filename = "";
   string gcp_filename = "";
   string dst_filename = "";
+  string map_cache_directory = "";
   int order = 1;
   int value = 0;
 
@@ -44,7 +45,10 @@ int main(int argc, char* argv[]) {
       "interpolation (nearest|bilinear) [default is nearest]")(
       "border-mode,m", po::value<string>(&border_mode_string),
       "border mode (constant|replicate) [default is constant]")(
-      "border-value,b", po::value<int>(&value), "border value [default is 0]");
+      "border-value,b", po::value<int>(&value), "border value [default is 0]")(
+      "map-cache-directory", po::value<string>(&map_cache_directory),
+      "directory in which to store computed maps for reuse [default is "
+      "empty, maps are not stored]");
 
   po::positional_options_description positional_options;
   positional_options.add("source-filename", 1);
@@ -123,6 +127,7 @@ int main(int argc, char* argv[]) {
     cout << "Border mode: " << border_mode_string << endl;
     cout << "Border value: " << value << endl;
     cout << "Destination filename: " << dst_filename << endl;
+    cout << "Map cache directory: " << map_cache_directory << endl;
   }
 
   uint8_t border_value = value;
@@ -174,7 +179,21 @@ int main(int argc, char* argv[]) {
   bool status = false;
   cv::Mat map1;
   cv::Mat map2;
-  status = ipcv::MapGCP(src, map, src_points, map_points, order, map1, map2);
+  vector<double> parameters = {static_cast<double>(order)};
+  for (size_t point = 0; point < src_points.size(); point++) {
+    parameters.push_back(src_points[point].x);
+    parameters.push_back(src_points[point].y);
+    parameters.push_back(map_points[point].x);
+    parameters.push_back(map_points[point].y);
+  }
+  ipcv::MapCache map_cache(8, map_cache_directory);
+  string key = ipcv::MapCacheKey("gcp", parameters, src.size(), map.size());
+  status = map_cache.Get(key,
+                         [&](cv::Mat& m1, cv::Mat& m2) {
+                           return ipcv::MapGCP(src, map, src_points,
+                                               map_points, order, m1, m2);
+                         },
+                         map1, map2);
 
   cv::Mat dst;
 //  cv::remap(src, dst, map1, map2, cv::INTER_NEAREST, cv::BORDER_CONSTANT,
@@ -188,6 +207,10 @@ int main(int argc, char* argv[]) {
     cout << "Elapsed time: "
          << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
          << " [s]" << endl;
+    ipcv::MapCacheStatistics statistics = map_cache.Statistics();
+    cout << "Map cache: " << statistics.memory_hits << " memory hits, "
+         << statistics.disk_hits << " disk hits, " << statistics.misses
+         << " misses" << endl;
   }
 
   cv::Mat overlay;
@@ -27,6 +27,7 @@ int main(int argc, char* argv[]) {
   string src_filename = "";
   string tgt_filename = "";
   string dst_filename = "";
+  string map_cache_directory = "";
   int value = 0;
 
   string interpolation_string = "nearest";
@@ -46,7 +47,10 @@ int main(int argc, char* argv[]) {
       "interpolation (nearest|bilinear) [default is nearest]")(
       "border-mode,m", po::value<string>(&border_mode_string),
       "border mode (constant|replicate) [default is constant]")(
-      "border-value,b", po::value<int>(&value), "border value [default is 0]");
+      "border-value,b", po::value<int>(&value), "border value [default is 0]")(
+      "map-cache-directory", po::value<string>(&map_cache_directory),
+      "directory in which to store computed maps for reuse [default is "
+      "empty, maps are not stored]");
 
   po::positional_options_description positional_options;
   positional_options.add("source-filename", 1);
@@ -113,6 +117,7 @@ int main(int argc, char* argv[]) {
     cout << "Border mode: " << border_mode_string << endl;
     cout << "Border value: " << value << endl;
     cout << "Destination filename: " << dst_filename << endl;
+    cout << "Map cache directory: " << map_cache_directory << endl;
   }
 
   uint8_t border_value = value;
@@ -132,7 +137,7 @@ int main(int argc, char* argv[]) {
        << endl;
   cout << endl;
 
-  vector<cv::Point> src_vertices(4);
+  vector<cv::Point2f> src_vertices(4);
   src_vertices[0].x = 0;
   src_vertices[0].y = 0;
   src_vertices[1].x = src.cols - 1;
@@ -147,7 +152,23 @@ int main(int argc, char* argv[]) {
   bool status = false;
   cv::Mat map1;
   cv::Mat map2;
-  status = ipcv::MapQ2Q(src, tgt, src_vertices, tgt_vertices, map1, map2);
+  vector<cv::Point2f> tgt_vertices_2f(tgt_vertices.begin(),
+                                      tgt_vertices.end());
+  vector<double> parameters;
+  for (int i = 0; i < 4; i++) {
+    parameters.push_back(src_vertices[i].x);
+    parameters.push_back(src_vertices[i].y);
+    parameters.push_back(tgt_vertices_2f[i].x);
+    parameters.push_back(tgt_vertices_2f[i].y);
+  }
+  ipcv::MapCache map_cache(8, map_cache_directory);
+  string key = ipcv::MapCacheKey("q2q", parameters, src.size(), tgt.size());
+  status = map_cache.Get(key,
+                         [&](cv::Mat& m1, cv::Mat& m2) {
+                           return ipcv::MapQ2Q(src, tgt, src_vertices,
+                                               tgt_vertices_2f, m1, m2);
+                         },
+                         map1, map2);
   clock_t endTime = clock();
     
   cv::Mat dst;
@@ -160,6 +181,10 @@ int main(int argc, char* argv[]) {
     cout << "Elapsed time: "
          << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
          << " [s]" << endl;
+    ipcv::MapCacheStatistics statistics = map_cache.Statistics();
+    cout << "Map cache: " << statistics.memory_hits << " memory hits, "
+         << statistics.disk_hits << " disk hits, " << statistics.misses
+         << " misses" << endl;
   }
 
   cv::Mat mask = 255 - (dst * 255);
@@ -22,6 +22,7 @@ int main(int argc, char* argv[]) {
   string src_filename = "";
   string dst_filename = "";
   string text_filename = "";
+  string map_cache_directory = "";
   double angle = 180;
   double scale_x = 1;
   double scale_y = 1;
@@ -57,7 +58,10 @@ int main(int argc, char* argv[]) {
       "border mode (constant|replicate) [default is constant]")(
       "border-value,b", po::value<int>(&value), "border value [default is 0]")
     (
-    "text-filename,c", po::value<string>(&text_filename), "text filename");
+    "text-filename,c", po::value<string>(&text_filename), "text filename")(
+      "map-cache-directory", po::value<string>(&map_cache_directory),
+      "directory in which to store computed maps for reuse [default is "
+      "empty, maps are not stored]");
 
   po::positional_options_description positional_options;
   positional_options.add("source-filename", -1);
@@ -117,6 +121,7 @@ int main(int argc, char* argv[]) {
     cout << "Border mode: " << border_mode_string << endl;
     cout << "Border value: " << value << endl;
     cout << "Destination filename: " << dst_filename << endl;
+    cout << "Map cache directory: " << map_cache_directory << endl;
   }
 
   double radians_per_degree = 3.14159265358979 / 180.0;
@@ -130,7 +135,6 @@ int main(int argc, char* argv[]) {
   cv::Mat map1;
   cv::Mat map2;
   cv::Mat dst;
-    vector<cv::Point2f> ptsOut(4);
 //  status = ipcv::MapRST(src, angle, scale_x, scale_y, translation_x,
 //                        translation_y, map1, map2);
 //    cv::remap(src, dst, map1, map2, cv::INTER_LINEAR, cv::BORDER_CONSTANT,
@@ -139,22 +143,57 @@ int main(int argc, char* argv[]) {
     double theta = 0*radians_per_degree;
     double phi = 0*radians_per_degree;
     double psi = 70*radians_per_degree;
-    status = ipcv::MapRotation3D(src, map1, map2, ptsOut, theta, phi, psi);
-    cv::remap(src, dst, map1, map2, cv::INTER_LINEAR);
-    cv::imshow("test", dst);
-
-    vector<cv::Point2f> ptsIn(4);
-    ptsIn[0].x = 0;
-    ptsIn[0].y = src.rows - 1;
-    ptsIn[1].x = src.cols - 1;
-    ptsIn[1].y = src.rows - 1;
-    ptsIn[2].x = src.cols - 1;
-    ptsIn[2].y = 0;
-    ptsIn[3].x = 0;
-    ptsIn[3].y = 0;
-
-    ipcv::MapQ2Q(dst, src, ptsOut, ptsIn, map1, map2);
-    cv::remap(dst, dst, map1, map2, cv::INTER_LINEAR);
+
+    // The 3D rotation and the quad-to-quad projection back onto the source
+    // frame only depend on the rotation angles and the source size, so the
+    // maps of both stages are looked up (or computed once and stored) by
+    // those.  The source is still resampled by each stage in turn, as
+    // composing the maps would interpolate across the edges of the
+    // rotated frame.
+    ipcv::MapCache map_cache(8, map_cache_directory);
+    vector<cv::Point2f> ptsOut(4);
+    bool rotated = false;
+    auto rotate = [&](cv::Mat& rotation_map1, cv::Mat& rotation_map2) {
+        rotated = ipcv::MapRotation3D(src, rotation_map1, rotation_map2,
+                                      ptsOut, theta, phi, psi);
+        return rotated;
+    };
+
+    cv::Mat q2q_map1, q2q_map2;
+    status = map_cache.Get(
+        ipcv::MapCacheKey("rotation3d", {theta, phi, psi}, src.size(),
+                          src.size()),
+        rotate, map1, map2);
+    status = status && map_cache.Get(
+        ipcv::MapCacheKey("rotation3d;q2q", {theta, phi, psi}, src.size(),
+                          src.size()),
+        [&](cv::Mat& stage_map1, cv::Mat& stage_map2) {
+            // The quad-to-quad mapping needs the corners of the rotated
+            // frame, which are only known once the rotation is computed
+            cv::Mat rotation_map1, rotation_map2;
+            if (!rotated && !rotate(rotation_map1, rotation_map2)) {
+                return false;
+            }
+
+            vector<cv::Point2f> ptsIn(4);
+            ptsIn[0].x = 0;
+            ptsIn[0].y = src.rows - 1;
+            ptsIn[1].x = src.cols - 1;
+            ptsIn[1].y = src.rows - 1;
+            ptsIn[2].x = src.cols - 1;
+            ptsIn[2].y = 0;
+            ptsIn[3].x = 0;
+            ptsIn[3].y = 0;
+
+            return ipcv::MapQ2Q(map1, src, ptsOut, ptsIn, stage_map1,
+                                stage_map2);
+        },
+        q2q_map1, q2q_map2);
+    if (status) {
+        cv::Mat rotated_src;
+        cv::remap(src, rotated_src, map1, map2, cv::INTER_LINEAR);
+        cv::remap(rotated_src, dst, q2q_map1, q2q_map2, cv::INTER_LINEAR);
+    }
 
   clock_t endTime = clock();
 
@@ -162,6 +201,10 @@ int main(int argc, char* argv[]) {
     cout << "Elapsed time: "
          << (endTime - startTime) / static_cast<double>(CLOCKS_PER_SEC)
          << " [s]" << endl;
+    ipcv::MapCacheStatistics statistics = map_cache.Statistics();
+    cout << "Map cache: " << statistics.memory_hits << " memory hits, "
+         << statistics.disk_hits << " disk hits, " << statistics.misses
+         << " misses" << endl;
   }
 
   if (status) {
@@ -7,6 +7,9 @@
 
 #include "BilateralFilter.h"
 #include <iostream>
+#include <vector>
+
+#include "imgs/ipcv/utils/LabLut.h"
 
 using namespace std;
 
@@ -79,16 +82,23 @@ bool BilateralFilter(const cv::Mat& src, cv::Mat& dst,
     dst.create(src.size(), CV_8UC3);
     // Color image case
     if(src.channels() == 3){
-        // Convert the input image from BGR to Lab
-        cv::cvtColor(padSrc, padSrc, cv::COLOR_BGR2Lab);
         // Create a copy of the src image in the Lab colorspace
         cv::cvtColor(src, dst, cv::COLOR_BGR2Lab);
-        padSrc.convertTo(padSrc, CV_32FC3);
-        // Split the Lab image into 3 seperate images
-        cv::Mat Lab[3];
-        cv::split(padSrc, Lab);
-        // Only apply the filter to the L channel
-        newSrc = Lab[0].clone();
+        // Only apply the filter to the L channel, its rows are streamed
+        // from the padded BGR image (scaled to [0, 255] like the 8-bit L
+        // channel of dst) without converting the whole image to Lab
+        ipcv::LabLut lut(CV_8U, 255);
+        newSrc.create(padSrc.size(), CV_32FC1);
+        cv::parallel_for_(cv::Range(0, padSrc.rows), [&](const cv::Range& range) {
+            vector<cv::Vec3f> lab(padSrc.cols);
+            for (int r = range.start; r < range.end; r++) {
+                lut.ConvertRow(padSrc, r, lab.data());
+                float* l = newSrc.ptr<float>(r);
+                for (int c = 0; c < padSrc.cols; c++) {
+                    l[c] = lab[c][0] * 255 / 100;
+                }
+            }
+        });
     }
     // Grayscale case
     else if (src.channels() == 1) {
@@ -0,0 +1,173 @@
+/** Implementation file for extracting corner features from a corner
+ *  response
+ *
+ *  \file ipcv/corners/CornerExtraction.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "CornerExtraction.h"
+#include "Harris.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <opencv2/core.hpp>
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+struct Candidate {
+    float response;
+    int x;
+    int y;
+};
+
+// Offset of the peak of the quadratic surface fit to the 3x3 neighborhood
+// of (x, y), left at zero when the fit has no maximum within one pixel
+cv::Point2f SubpixelOffset(const cv::Mat& response, const int x,
+                           const int y) {
+    const float* above = response.ptr<float>(y - 1);
+    const float* row = response.ptr<float>(y);
+    const float* below = response.ptr<float>(y + 1);
+    float dx = 0.5f * (row[x + 1] - row[x - 1]);
+    float dy = 0.5f * (below[x] - above[x]);
+    float dxx = row[x + 1] - 2 * row[x] + row[x - 1];
+    float dyy = below[x] - 2 * row[x] + above[x];
+    float dxy = 0.25f * (below[x + 1] - below[x - 1] - above[x + 1] +
+                         above[x - 1]);
+    float det = dxx * dyy - dxy * dxy;
+    // A maximum requires a negative definite Hessian
+    if (!(det > 0) || dxx >= 0) {
+        return cv::Point2f(0, 0);
+    }
+    cv::Point2f offset((dxy * dy - dyy * dx) / det,
+                       (dxy * dx - dxx * dy) / det);
+    if (fabs(offset.x) > 1 || fabs(offset.y) > 1) {
+        return cv::Point2f(0, 0);
+    }
+    return offset;
+}
+}
+
+bool ExtractCorners(const cv::Mat& response, vector<cv::KeyPoint>& corners,
+                    const int max_corners, const float min_distance,
+                    const float quality_level, const bool subpixel) {
+    corners.clear();
+    if (response.type() != CV_32FC1) {
+        cerr << "Corner extraction requires a CV_32FC1 response image"
+             << endl;
+        return false;
+    }
+
+    // 3x3 local maxima with a positive response (ties are resolved in
+    // favour of the first pixel in raster order), the one pixel border is
+    // skipped so every candidate has a full neighborhood
+    vector<Candidate> candidates;
+    float strongest = 0;
+    for (int y = 1; y < response.rows - 1; y++) {
+        const float* above = response.ptr<float>(y - 1);
+        const float* row = response.ptr<float>(y);
+        const float* below = response.ptr<float>(y + 1);
+        for (int x = 1; x < response.cols - 1; x++) {
+            float r = row[x];
+            if (r <= 0 || r < above[x - 1] || r < above[x] ||
+                r < above[x + 1] || r < row[x - 1] || r <= row[x + 1] ||
+                r <= below[x - 1] || r <= below[x] || r <= below[x + 1]) {
+                continue;
+            }
+            candidates.push_back({r, x, y});
+            strongest = max(strongest, r);
+        }
+    }
+
+    float threshold = max(quality_level, 0.f) * strongest;
+    candidates.erase(remove_if(candidates.begin(), candidates.end(),
+                               [threshold](const Candidate& c) {
+                                   return c.response < threshold;
+                               }),
+                     candidates.end());
+    sort(candidates.begin(), candidates.end(),
+         [](const Candidate& a, const Candidate& b) {
+             return a.response > b.response;
+         });
+
+    // Greedy selection, strongest first, rejecting candidates within the
+    // minimum distance of an already selected corner.  Selected corners are
+    // binned into cells the size of the minimum distance so only the 3x3
+    // surrounding cells need to be checked.
+    const bool spaced = min_distance > 0;
+    const float cell_size = spaced ? min_distance : 1;
+    const int grid_cols = static_cast<int>(response.cols / cell_size) + 1;
+    const int grid_rows = static_cast<int>(response.rows / cell_size) + 1;
+    vector<vector<cv::Point>> grid(spaced ? grid_cols * grid_rows : 0);
+    const float min_distance2 = min_distance * min_distance;
+    const size_t limit = max_corners > 0 ? max_corners : candidates.size();
+
+    for (const auto& candidate : candidates) {
+        if (corners.size() >= limit) {
+            break;
+        }
+        if (spaced) {
+            int gx = static_cast<int>(candidate.x / cell_size);
+            int gy = static_cast<int>(candidate.y / cell_size);
+            bool too_close = false;
+            for (int j = max(gy - 1, 0);
+                 j <= min(gy + 1, grid_rows - 1) && !too_close; j++) {
+                for (int i = max(gx - 1, 0);
+                     i <= min(gx + 1, grid_cols - 1) && !too_close; i++) {
+                    for (const auto& p : grid[j * grid_cols + i]) {
+                        float dx = p.x - candidate.x;
+                        float dy = p.y - candidate.y;
+                        if (dx * dx + dy * dy < min_distance2) {
+                            too_close = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (too_close) {
+                continue;
+            }
+            grid[gy * grid_cols + gx].push_back(
+                cv::Point(candidate.x, candidate.y));
+        }
+
+        cv::Point2f location(candidate.x, candidate.y);
+        if (subpixel) {
+            location += SubpixelOffset(response, candidate.x, candidate.y);
+        }
+        corners.emplace_back(location, 1.f, -1.f, candidate.response);
+    }
+
+    return true;
+}
+
+bool ExtractCorners(const cv::Mat& src, vector<cv::KeyPoint>& corners,
+                    const int max_corners, const float min_distance,
+                    const float quality_level, const CornerMeasure measure,
+                    const float sigma, const float k, const bool subpixel) {
+    corners.clear();
+    cv::Mat response;
+    bool status = measure == CornerMeasure::shi_tomasi
+                      ? ShiTomasi(src, response, sigma)
+                      : Harris(src, response, sigma, k);
+    if (!status) {
+        return false;
+    }
+    if (!ExtractCorners(response, corners, max_corners, min_distance,
+                        quality_level, subpixel)) {
+        return false;
+    }
+
+    // Report the size of the Gaussian window the response was computed over
+    const float size = static_cast<float>(cvRound(sigma * 4 * 2 + 1) | 1);
+    for (auto& corner : corners) {
+        corner.size = size;
+    }
+    return true;
+}
+}
@@ -0,0 +1,75 @@
+/** Interface file for extracting corner features from a corner response
+ *
+ *  \file ipcv/corners/CornerExtraction.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+using namespace std;
+
+namespace ipcv {
+
+/// Available corner measures
+enum class CornerMeasure {
+  harris,     ///< Harris response, det - k tr^2
+  shi_tomasi  ///< Shi-Tomasi response, minimum eigenvalue
+};
+
+/** Extract the strongest corners of a color image
+ *
+ *  The corner response is computed (see Harris and ShiTomasi), reduced to
+ *  its 3x3 local maxima, and the strongest maxima are selected greedily
+ *  while enforcing a minimum distance between the selected corners (using
+ *  a grid with cells the size of the minimum distance).  The location of
+ *  every selected corner is optionally refined to sub-pixel accuracy by
+ *  fitting a quadratic surface to its 3x3 neighborhood in the response.
+ *
+ *  \param[in] src            source cv::Mat of CV_8UC3 or CV_8UC1
+ *  \param[out] corners       selected corners, strongest first (response
+ *                            is the corner response, size is the Gaussian
+ *                            window size)
+ *  \param[in] max_corners    maximum number of corners [0 = no limit]
+ *  \param[in] min_distance   minimum distance [pixels] between corners
+ *  \param[in] quality_level  minimum response of a corner relative to the
+ *                            strongest response in the image
+ *  \param[in] measure        corner measure
+ *  \param[in] sigma          standard deviation of the Gaussian window
+ *  \param[in] k              free parameter of the Harris response
+ *  \param[in] subpixel       refine the corner locations to sub-pixel
+ *                            accuracy
+ *
+ *  \return a boolean indicating that the corners were extracted without
+ *          error
+ */
+bool ExtractCorners(const cv::Mat& src, vector<cv::KeyPoint>& corners,
+                    const int max_corners = 500,
+                    const float min_distance = 10,
+                    const float quality_level = 0.01,
+                    const CornerMeasure measure = CornerMeasure::harris,
+                    const float sigma = 1, const float k = 0.04,
+                    const bool subpixel = true);
+
+/** Extract the strongest corners from a corner response image
+ *
+ *  \param[in] response       corner response cv::Mat of CV_32FC1
+ *  \param[out] corners       selected corners, strongest first
+ *  \param[in] max_corners    maximum number of corners [0 = no limit]
+ *  \param[in] min_distance   minimum distance [pixels] between corners
+ *  \param[in] quality_level  minimum response of a corner relative to the
+ *                            strongest response in the image
+ *  \param[in] subpixel       refine the corner locations to sub-pixel
+ *                            accuracy
+ *
+ *  \return a boolean indicating that the corners were extracted without
+ *          error
+ */
+bool ExtractCorners(const cv::Mat& response, vector<cv::KeyPoint>& corners,
+                    const int max_corners, const float min_distance,
+                    const float quality_level, const bool subpixel);
+}
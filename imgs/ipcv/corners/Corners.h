@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include "imgs/ipcv/corners/CornerExtraction.h"
 #include "imgs/ipcv/corners/Fast.h"
+#include "imgs/ipcv/corners/FastPyramid.h"
 #include "imgs/ipcv/corners/Harris.h"
 
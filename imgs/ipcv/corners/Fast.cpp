@@ -7,19 +7,276 @@
 
 #include "Corners.h"
 
+#include <algorithm>
 #include <iostream>
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 #include "opencv2/imgproc.hpp"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 namespace ipcv {
 
+namespace {
+
+// Radius of the Bresenham circle surrounding each candidate pixel
+const int kRadius = 3;
+
+// Offsets (column, row) of the 16 pixels on the circle, in circular order
+const int kCircle[16][2] = {{0, -3}, {1, -3},  {2, -2},  {3, -1},
+                            {3, 0},  {3, 1},   {2, 2},   {1, 3},
+                            {0, 3},  {-1, 3},  {-2, 2},  {-3, 1},
+                            {-3, 0}, {-3, -1}, {-2, -2}, {-1, -3}};
+
+// Segment test for a single pixel: is there an arc of at least `arc`
+// contiguous circle pixels all brighter than center + threshold or all
+// darker than center - threshold?
+bool SegmentTest(const uchar* p, const int* offsets, const int threshold,
+                 const int arc) {
+    int upper = p[0] + threshold;
+    int lower = p[0] - threshold;
+    int bright = 0;
+    int dark = 0;
+    for (int k = 0; k < 16 + arc - 1; k++) {
+        int x = p[offsets[k & 15]];
+        bright = x > upper ? bright + 1 : 0;
+        dark = x < lower ? dark + 1 : 0;
+        if (bright >= arc || dark >= arc) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Corner score: the larger of the summed brighter and summed darker
+// differences beyond the threshold (positive for every detected corner)
+int CornerScore(const uchar* p, const int* offsets, const int threshold) {
+    int bright = 0;
+    int dark = 0;
+    for (int k = 0; k < 16; k++) {
+        int d = p[offsets[k]] - p[0];
+        if (d > threshold) {
+            bright += d - threshold;
+        } else if (-d > threshold) {
+            dark += -d - threshold;
+        }
+    }
+    return max(bright, dark);
+}
+
+#if defined(__SSE2__)
+// Run the segment test on the 16 consecutive pixels starting at p, returning
+// a bit mask of the pixels that are corners
+int SegmentTest16(const uchar* p, const int* offsets, const int threshold,
+                  const int arc) {
+    // Unsigned comparisons are carried out as signed comparisons on values
+    // biased by 128 (SSE2 has no unsigned byte compare)
+    const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i t = _mm_set1_epi8(static_cast<char>(threshold));
+    __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i upper = _mm_xor_si128(_mm_adds_epu8(center, t), bias);
+    __m128i lower = _mm_xor_si128(_mm_subs_epu8(center, t), bias);
+
+    __m128i bright[16];
+    __m128i dark[16];
+    auto compare = [&](const int k) {
+        __m128i x = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + offsets[k])),
+            bias);
+        bright[k] = _mm_cmpgt_epi8(x, upper);
+        dark[k] = _mm_cmpgt_epi8(lower, x);
+    };
+
+    // High-speed rejection: an arc of length N covers at least N/4 of the
+    // four compass points (0, 4, 8, 12), so compare those first and skip the
+    // block when no pixel passes
+    const int compass = arc / 4;
+    if (compass > 0) {
+        __m128i bright_count = _mm_setzero_si128();
+        __m128i dark_count = _mm_setzero_si128();
+        for (int k = 0; k < 16; k += 4) {
+            compare(k);
+            bright_count = _mm_sub_epi8(bright_count, bright[k]);
+            dark_count = _mm_sub_epi8(dark_count, dark[k]);
+        }
+        const __m128i needed = _mm_set1_epi8(static_cast<char>(compass - 1));
+        __m128i candidates = _mm_or_si128(_mm_cmpgt_epi8(bright_count, needed),
+                                          _mm_cmpgt_epi8(dark_count, needed));
+        if (_mm_movemask_epi8(candidates) == 0) {
+            return 0;
+        }
+        for (int k = 0; k < 16; k++) {
+            if (k % 4 != 0) {
+                compare(k);
+            }
+        }
+    } else {
+        for (int k = 0; k < 16; k++) {
+            compare(k);
+        }
+    }
+
+    // Longest run of consecutive brighter (darker) circle pixels per lane,
+    // wrapping around the circle
+    __m128i bright_run = _mm_setzero_si128();
+    __m128i dark_run = _mm_setzero_si128();
+    __m128i bright_max = _mm_setzero_si128();
+    __m128i dark_max = _mm_setzero_si128();
+    for (int k = 0; k < 16 + arc - 1; k++) {
+        bright_run = _mm_and_si128(_mm_sub_epi8(bright_run, bright[k & 15]),
+                                   bright[k & 15]);
+        dark_run =
+            _mm_and_si128(_mm_sub_epi8(dark_run, dark[k & 15]), dark[k & 15]);
+        bright_max = _mm_max_epu8(bright_max, bright_run);
+        dark_max = _mm_max_epu8(dark_max, dark_run);
+    }
+    const __m128i longest = _mm_set1_epi8(static_cast<char>(arc - 1));
+    __m128i corners = _mm_or_si128(_mm_cmpgt_epi8(bright_max, longest),
+                                   _mm_cmpgt_epi8(dark_max, longest));
+    return _mm_movemask_epi8(corners);
+}
+#endif
+
+// Detect the corners of a single row, writing the scores of the detected
+// corners into score (zero elsewhere) and their columns into columns
+void DetectRow(const cv::Mat& gray, const int r, const int* offsets,
+               const int threshold, const int arc, int* score,
+               vector<int>& columns) {
+    const uchar* row = gray.ptr<uchar>(r);
+    fill(score, score + gray.cols, 0);
+    columns.clear();
+
+    int c = kRadius;
+    const int c_end = gray.cols - kRadius;
+#if defined(__SSE2__)
+    for (; c + 16 <= c_end; c += 16) {
+        int mask = SegmentTest16(row + c, offsets, threshold, arc);
+        while (mask) {
+            int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            score[c + lane] = CornerScore(row + c + lane, offsets, threshold);
+            columns.push_back(c + lane);
+        }
+    }
+#endif
+    for (; c < c_end; c++) {
+        if (SegmentTest(row + c, offsets, threshold, arc)) {
+            score[c] = CornerScore(row + c, offsets, threshold);
+            columns.push_back(c);
+        }
+    }
+}
+}
+
+/** Apply the FAST corner detector to a color image, also returning the
+ *  detected corners as keypoints
+ *
+ *  \param[in] src     source cv::Mat of CV_8UC3 or CV_8UC1
+ *  \param[out] dst    destination cv:Mat of CV_8UC1 (255 at corners, 0
+ *                     elsewhere)
+ *  \param[out] keypoints
+ *                     detected corners, the response of each keypoint is
+ *                     its corner score
+ *  \param[in] difference_threshold
+ *                     brightness threshold to be used to determine whether
+ *                     a surrounding pixels is brighter than or darker than
+ *                     the candidate corner pixel
+ *  \param[in] contiguous_threshold
+ *                     number of contiguous pixels that must appear in
+ *                     sequence in order for a candidate pixel to be
+ *                     considered a corner pixel
+ *  \param[in] nonmaximal_suppression
+ *                     boolean parameter indicating whether 3x3 non-maximal
+ *                     suppression of the corner score should be used
+ */
+bool Fast(const cv::Mat& src, cv::Mat& dst, vector<cv::KeyPoint>& keypoints,
+          const int difference_threshold, const int contiguous_threshold,
+          const bool nonmaximal_supression) {
+    keypoints.clear();
+    if (src.depth() != CV_8U ||
+        (src.channels() != 1 && src.channels() != 3)) {
+        cerr << "FAST requires a CV_8UC1 or CV_8UC3 source image" << endl;
+        return false;
+    }
+    if (contiguous_threshold < 1 || contiguous_threshold > 16) {
+        cerr << "FAST contiguous threshold must be in [1, 16]" << endl;
+        return false;
+    }
+
+    cv::Mat src_gray;
+    if (src.channels() == 3) {
+        cv::cvtColor(src, src_gray, cv::COLOR_BGR2GRAY);
+    } else {
+        src_gray = src;
+    }
+
+    dst = cv::Mat::zeros(src_gray.size(), CV_8UC1);
+    if (src_gray.rows <= 2 * kRadius || src_gray.cols <= 2 * kRadius) {
+        return true;
+    }
+
+    // Byte offsets of the circle pixels relative to the candidate pixel
+    int offsets[16];
+    for (int k = 0; k < 16; k++) {
+        offsets[k] = kCircle[k][0] +
+                     kCircle[k][1] * static_cast<int>(src_gray.step[0]);
+    }
+    int threshold = min(max(difference_threshold, 0), 255);
+
+    auto emit = [&](const int r, const int c, const int score) {
+        dst.ptr<uchar>(r)[c] = 255;
+        keypoints.emplace_back(cv::Point2f(c, r), 2.f * kRadius + 1, -1.f,
+                               static_cast<float>(score));
+    };
+
+    // Scores of three consecutive rows are kept in a ring so that 3x3
+    // non-maximal suppression streams one row behind the detection
+    const int cols = src_gray.cols;
+    vector<int> scores(3 * cols, 0);
+    vector<vector<int>> columns(3);
+    auto suppress = [&](const int r) {
+        const int* above = &scores[((r - 1) % 3) * cols];
+        const int* current = &scores[(r % 3) * cols];
+        const int* below = &scores[((r + 1) % 3) * cols];
+        for (int c : columns[r % 3]) {
+            int s = current[c];
+            if (s > above[c - 1] && s > above[c] && s > above[c + 1] &&
+                s > current[c - 1] && s > current[c + 1] &&
+                s > below[c - 1] && s > below[c] && s > below[c + 1]) {
+                emit(r, c, s);
+            }
+        }
+    };
+
+    const int r_end = src_gray.rows - kRadius;
+    for (int r = kRadius; r < r_end; r++) {
+        DetectRow(src_gray, r, offsets, threshold, contiguous_threshold,
+                  &scores[(r % 3) * cols], columns[r % 3]);
+        if (!nonmaximal_supression) {
+            for (int c : columns[r % 3]) {
+                emit(r, c, scores[(r % 3) * cols + c]);
+            }
+        } else if (r > kRadius) {
+            suppress(r - 1);
+        }
+    }
+    if (nonmaximal_supression) {
+        fill(scores.begin() + (r_end % 3) * cols,
+             scores.begin() + (r_end % 3 + 1) * cols, 0);
+        suppress(r_end - 1);
+    }
+
+    return true;
+}
+
 /** Apply the FAST corner detector to a color image
  *
  *  \param[in] src     source cv::Mat of CV_8UC3
- *  \param[out] dst    destination cv:Mat of CV_8UC3
+ *  \param[out] dst    destination cv:Mat of CV_8UC1
  *  \param[in] difference_threshold
  *                     brightness threshold to be used to determine whether
  *                     a surrounding pixels is brighter than or darker than
@@ -35,122 +292,8 @@ namespace ipcv {
  */
 bool Fast(const cv::Mat& src, cv::Mat& dst, const int difference_threshold,
           const int contiguous_threshold, const bool nonmaximal_supression) {
-    cv::Mat src_gray;
-    cv::cvtColor(src, src_gray, cv::COLOR_BGR2GRAY);
-
-    dst.create(src.size(), CV_8UC1);
-    // Create a list of values that represent a circle of radius three in image pixels
-    int circle[25];
-    circle[0] = 0 + src.step * 3;
-    circle[1] = 1 + src.step * 3;
-    circle[2] = 2 + src.step * 2;
-    circle[3] = 3 + src.step * 1;
-    circle[4] = 3 + src.step * 0;
-    circle[5] = 3 + src.step * -1;
-    circle[6] = 2 + src.step * -2;
-    circle[7] = 1 + src.step * -3;
-    circle[8] = 0 + src.step * -3;
-    circle[9] = -1 + src.step * -3;
-    circle[10] = -2 + src.step * -2;
-    circle[11] = -3 + src.step * -1;
-    circle[12] = -3 + src.step * 0;
-    circle[13] = -3 + src.step * 1;
-    circle[14] = -2 + src.step * 2;
-    circle[15] = -1 + src.step * 3;
-    for(int k = 16; k < 25; k++) circle[k] = circle[k - 16];
-    
-    int radius = 4;
-    int diameter = 2*radius+1;
-    cv::Rect r;
-    int topAdd, topSub, botAdd, botSub, leftAdd, leftSub, rightAdd, rightSub;
-    // Loop through every pixel of the src image within the diameter of the search circle
-    for (int i = diameter;i<src.rows-diameter;i++){
-        // Create pointers into the src and dst image rows
-        const uchar* ptr = src_gray.ptr<uchar>(i);
-        uchar* output = dst.ptr<uchar>(i);
-        for (int j = diameter;j<src.cols-diameter;j++, ptr++){
-            int above = 0;
-            int below = 0;
-            // Check if the top or bottom circle pixels are outside the diff thresh
-            topAdd = ptr[circle[0]]+difference_threshold;
-            if (topAdd > ptr[0]) {
-                above++;
-            }
-            botAdd = ptr[circle[8]]+difference_threshold;
-            if (botAdd > ptr[0]) {
-                above++;
-            }
-            topSub = ptr[circle[0]]-difference_threshold;
-            if (topSub < ptr[0]) {
-                below++;
-            }
-            botSub = ptr[circle[8]]-difference_threshold;
-            if (botSub < ptr[0]) {
-                below++;
-            }
-            // Check if the left or right circle pixels are outside the diff thresh
-            if (above == 0 && below == 0){
-                continue;
-            }
-            leftAdd = ptr[circle[4]]+difference_threshold;
-            if (leftAdd > ptr[0]) {
-                above++;
-            }
-            rightAdd = ptr[circle[12]]+difference_threshold;
-            if (rightAdd > ptr[0]) {
-                above++;
-            }
-            leftSub = ptr[circle[4]]-difference_threshold;
-            if (leftSub < ptr[0]) {
-                below++;
-            }
-            rightSub = ptr[circle[12]]-difference_threshold;
-            if (rightSub < ptr[0]) {
-                below++;
-            }
-            // If more than 3 pixels are above thresh, check the rest
-            if (above >= 3) {
-                // Create value threshold
-                int vt = ptr[0] + difference_threshold, count = 0;
-                // Loop through each pixel in the circle
-                for(int k = 0; k < 25; k++ )
-                {
-                    int x = ptr[circle[k]];
-                    if(x > vt)
-                    {
-                        // If the number of connected pixels is greater than the thresh, pixel is a corner
-                        if( ++count > contiguous_threshold)
-                        {
-                            output[j] = 255;
-                        }
-                    }
-                    // If not a connected pixel, restart the count
-                    else
-                        count = 0;
-                }
-            }
-            // If more than 3 pixels are below thresh, check the rest
-            else if (below >= 3) {
-                int vt = ptr[0] - difference_threshold, count = 0;
-                // Loop through each pixel in the circle
-                for(int k = 0; k < 25; k++ )
-                {
-                    int x = ptr[circle[k]];
-                    if(x < vt)
-                    {
-                        // If the number of connected pixels is greater than the thresh, pixel is a corner
-                        if( ++count > contiguous_threshold)
-                        {
-                            output[j] = 255;
-                        }
-                    }
-                    // If not a connected pixel, restart the count
-                    else
-                        count = 0;
-                }
-            }
-        }
-    }
-  return true;
+    vector<cv::KeyPoint> keypoints;
+    return Fast(src, dst, keypoints, difference_threshold,
+                contiguous_threshold, nonmaximal_supression);
 }
 }
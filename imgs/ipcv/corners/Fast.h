@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <opencv2/core.hpp>
 
 using namespace std;
@@ -33,4 +35,33 @@ namespace ipcv {
 bool Fast(const cv::Mat& src, cv::Mat& dst, const int difference_threshold = 50,
           const int contiguous_threshold = 12,
           const bool nonmaximal_supression = false);
+
+/** Apply the FAST corner detector to a color image, also returning the
+ *  detected corners as keypoints
+ *
+ *  \param[in] src     source cv::Mat of CV_8UC3 or CV_8UC1
+ *  \param[out] dst    destination cv:Mat of CV_8UC1 (255 at corners, 0
+ *                     elsewhere)
+ *  \param[out] keypoints
+ *                     detected corners, the response of each keypoint is
+ *                     its corner score (sum of the absolute differences
+ *                     beyond the difference threshold of the brighter or
+ *                     darker circle pixels, whichever is larger)
+ *  \param[in] difference_threshold
+ *                     brightness threshold to be used to determine whether
+ *                     a surrounding pixels is brighter than or darker than
+ *                     the candidate corner pixel
+ *  \param[in] contiguous_threshold
+ *                     number of contiguous pixels [1, 16] that must appear
+ *                     in sequence in order for a candidate pixel to be
+ *                     considered a corner pixel
+ *  \param[in] nonmaximal_suppression
+ *                     boolean parameter indicating whether 3x3 non-maximal
+ *                     suppression of the corner score should be used to
+ *                     eliminate "clumping" of identified corner points
+ */
+bool Fast(const cv::Mat& src, cv::Mat& dst, vector<cv::KeyPoint>& keypoints,
+          const int difference_threshold = 50,
+          const int contiguous_threshold = 12,
+          const bool nonmaximal_supression = false);
 }
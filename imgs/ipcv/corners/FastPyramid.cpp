@@ -0,0 +1,152 @@
+/** Implementation file for multi-scale FAST keypoint detection
+ *
+ *  \file ipcv/corners/FastPyramid.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "FastPyramid.h"
+#include "Fast.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <opencv2/core.hpp>
+#include "opencv2/imgproc.hpp"
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+bool StrongerResponse(const cv::KeyPoint& a, const cv::KeyPoint& b) {
+    return a.response > b.response;
+}
+}
+
+FastPyramid::FastPyramid(const int levels, const double scale_factor) {
+    int n = max(levels, 1);
+    double factor = max(scale_factor, 1.0);
+    scales_.resize(n);
+    for (int l = 0; l < n; l++) {
+        scales_[l] = pow(factor, l);
+    }
+    images_.resize(n);
+    corners_.resize(n);
+    keypoints_.resize(n);
+}
+
+bool FastPyramid::Detect(const cv::Mat& src, vector<cv::KeyPoint>& keypoints,
+                         const int difference_threshold,
+                         const int contiguous_threshold, const int cell_size,
+                         const int keypoints_per_cell,
+                         const int max_keypoints) {
+    keypoints.clear();
+    if (src.depth() != CV_8U ||
+        (src.channels() != 1 && src.channels() != 3)) {
+        cerr << "FAST pyramid requires a CV_8UC1 or CV_8UC3 source image"
+             << endl;
+        return false;
+    }
+    if (cell_size < 1 || keypoints_per_cell < 1) {
+        cerr << "FAST pyramid cell size and keypoints per cell must be "
+             << "positive" << endl;
+        return false;
+    }
+
+    // Build the levels, each resampled from the previous one.  The level
+    // buffers are only reallocated when the frame size changes.
+    if (src.channels() == 3) {
+        cv::cvtColor(src, images_[0], cv::COLOR_BGR2GRAY);
+    } else {
+        src.copyTo(images_[0]);
+    }
+    for (int l = 1; l < Levels(); l++) {
+        cv::Size size(cvRound(src.cols / scales_[l]),
+                      cvRound(src.rows / scales_[l]));
+        if (size.width < 1 || size.height < 1) {
+            images_[l].create(0, 0, CV_8UC1);
+            continue;
+        }
+        cv::resize(images_[l - 1], images_[l], size, 0, 0, cv::INTER_AREA);
+    }
+
+    // Detect on all levels in parallel
+    vector<char> status(Levels(), true);
+    cv::parallel_for_(cv::Range(0, Levels()), [&](const cv::Range& range) {
+        for (int l = range.start; l < range.end; l++) {
+            keypoints_[l].clear();
+            if (images_[l].empty()) {
+                continue;
+            }
+            status[l] = Fast(images_[l], corners_[l], keypoints_[l],
+                             difference_threshold, contiguous_threshold, true);
+        }
+    });
+    if (find(status.begin(), status.end(), false) != status.end()) {
+        return false;
+    }
+
+    // Bring the keypoints to full resolution coordinates and assign each
+    // to its grid cell
+    const int grid_cols = (src.cols + cell_size - 1) / cell_size;
+    const int grid_rows = (src.rows + cell_size - 1) / cell_size;
+    const int n_cells = grid_cols * grid_rows;
+    cells_.clear();
+    offsets_.assign(n_cells + 1, 0);
+    for (int l = 0; l < Levels(); l++) {
+        const float scale = static_cast<float>(scales_[l]);
+        for (auto& keypoint : keypoints_[l]) {
+            keypoint.pt *= scale;
+            keypoint.size *= scale;
+            keypoint.octave = l;
+            int x = min(static_cast<int>(keypoint.pt.x), src.cols - 1);
+            int y = min(static_cast<int>(keypoint.pt.y), src.rows - 1);
+            int cell = (y / cell_size) * grid_cols + x / cell_size;
+            cells_.push_back(cell);
+            offsets_[cell + 1]++;
+        }
+    }
+
+    // Counting sort of the keypoints by cell
+    for (int i = 0; i < n_cells; i++) {
+        offsets_[i + 1] += offsets_[i];
+    }
+    sorted_.resize(cells_.size());
+    size_t i = 0;
+    for (int l = 0; l < Levels(); l++) {
+        for (const auto& keypoint : keypoints_[l]) {
+            sorted_[offsets_[cells_[i++]]++] = keypoint;
+        }
+    }
+
+    // Keep the strongest responses of each cell (offsets_ now holds the
+    // end of each cell)
+    int begin = 0;
+    for (int cell = 0; cell < n_cells; cell++) {
+        int end = offsets_[cell];
+        auto first = sorted_.begin() + begin;
+        auto last = sorted_.begin() + end;
+        if (end - begin > keypoints_per_cell) {
+            nth_element(first, first + keypoints_per_cell - 1, last,
+                        StrongerResponse);
+            last = first + keypoints_per_cell;
+        }
+        keypoints.insert(keypoints.end(), first, last);
+        begin = end;
+    }
+
+    // Cap the overall count, strongest first
+    if (max_keypoints > 0 &&
+        keypoints.size() > static_cast<size_t>(max_keypoints)) {
+        partial_sort(keypoints.begin(), keypoints.begin() + max_keypoints,
+                     keypoints.end(), StrongerResponse);
+        keypoints.resize(max_keypoints);
+    } else {
+        sort(keypoints.begin(), keypoints.end(), StrongerResponse);
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,84 @@
+/** Interface file for multi-scale FAST keypoint detection
+ *
+ *  \file ipcv/corners/FastPyramid.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    FAST is run on every level of an image pyramid (levels are detected
+ *    in parallel) and the resulting keypoints are bucketed into a grid of
+ *    cells over the full resolution image.  Only the strongest responses
+ *    of each cell are kept, and the overall number of keypoints is capped,
+ *    so the keypoints are well distributed and the cost of downstream
+ *    processing is bounded regardless of the image texture.
+ *
+ *    The pyramid buffers are held by the object and reused from one frame
+ *    to the next (as long as the frame size does not change).
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+using namespace std;
+
+namespace ipcv {
+
+class FastPyramid {
+ public:
+  /** Create a FAST pyramid
+   *
+   *  \param[in] levels        number of pyramid levels (level 0 is the
+   *                           full resolution image) [default is 4]
+   *  \param[in] scale_factor  ratio between the size of consecutive levels
+   *                           [default is 2]
+   */
+  explicit FastPyramid(const int levels = 4, const double scale_factor = 2.0);
+
+  /** Detect FAST keypoints on all levels of the pyramid
+   *
+   *  \param[in] src     source cv::Mat of CV_8UC3 or CV_8UC1
+   *  \param[out] keypoints
+   *                     detected keypoints in full resolution coordinates
+   *                     (octave is the pyramid level, size is the FAST
+   *                     circle diameter at that level), strongest first
+   *  \param[in] difference_threshold
+   *                     brightness threshold (see Fast)
+   *  \param[in] contiguous_threshold
+   *                     contiguous pixel threshold (see Fast)
+   *  \param[in] cell_size
+   *                     size [pixels] of the square bucketing cells in the
+   *                     full resolution image
+   *  \param[in] keypoints_per_cell
+   *                     maximum number of keypoints kept per cell
+   *  \param[in] max_keypoints
+   *                     maximum number of keypoints returned [0 = no limit]
+   *
+   *  \return            a boolean indicating that the detection succeeded
+   */
+  bool Detect(const cv::Mat& src, vector<cv::KeyPoint>& keypoints,
+              const int difference_threshold = 20,
+              const int contiguous_threshold = 9, const int cell_size = 32,
+              const int keypoints_per_cell = 4, const int max_keypoints = 1000);
+
+  /// Number of pyramid levels
+  int Levels() const { return static_cast<int>(scales_.size()); }
+
+  /// Image of the provided pyramid level from the most recent detection
+  const cv::Mat& Level(const int level) const { return images_[level]; }
+
+  /// Scale of the provided pyramid level relative to the full resolution
+  double Scale(const int level) const { return scales_[level]; }
+
+ private:
+  vector<double> scales_;
+  vector<cv::Mat> images_;
+  vector<cv::Mat> corners_;
+  vector<vector<cv::KeyPoint>> keypoints_;
+  vector<int> cells_;
+  vector<int> offsets_;
+  vector<cv::KeyPoint> sorted_;
+};
+}
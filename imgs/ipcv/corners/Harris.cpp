@@ -7,7 +7,10 @@
 
 #include "Corners.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <vector>
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 #include "opencv2/imgproc.hpp"
@@ -16,9 +19,198 @@ using namespace std;
 
 namespace ipcv {
 
+namespace {
+
+// Reflect an out-of-range index back into [0, length) the same way
+// cv::BORDER_REFLECT_101 (cv::BORDER_DEFAULT) does
+int Reflect101(int p, const int length) {
+    if (length == 1) {
+        return 0;
+    }
+    while (p < 0 || p >= length) {
+        p = p < 0 ? -p : 2 * length - 2 - p;
+    }
+    return p;
+}
+
+// Compute a corner response from the Gaussian-windowed structure tensor
+// [a c; c b] of every pixel.
+//
+// The computation is fused and streamed over the rows of the image: for
+// every row the 3x3 Sobel gradients, their products and the horizontal
+// pass of the separable Gaussian window are computed and pushed into a
+// ring buffer holding as many rows as the Gaussian kernel, from which the
+// vertical pass and the response of the centre row are produced.  Only the
+// ring buffers are held in memory (O(width * kernel size) per band of
+// rows) and bands of rows are processed in parallel.  The results match
+// cv::Sobel followed by cv::GaussianBlur (kernel size derived from sigma,
+// cv::BORDER_DEFAULT borders).
+template <typename Response>
+bool StructureTensorResponse(const cv::Mat& src, cv::Mat& dst,
+                             const float sigma, Response response) {
+    if (src.depth() != CV_8U ||
+        (src.channels() != 1 && src.channels() != 3)) {
+        cerr << "Corner response requires a CV_8UC1 or CV_8UC3 source image" << endl;
+        return false;
+    }
+    if (!(sigma > 0)) {
+        cerr << "Corner response requires a positive Gaussian standard "
+             << "deviation" << endl;
+        return false;
+    }
+
+    cv::Mat src_gray;
+    if (src.channels() == 3) {
+        cv::cvtColor(src, src_gray, cv::COLOR_BGR2GRAY);
+    } else {
+        src_gray = src;
+    }
+
+    const int rows = src_gray.rows;
+    const int cols = src_gray.cols;
+    dst.create(src_gray.size(), CV_32FC1);
+    if (rows == 0 || cols == 0) {
+        return true;
+    }
+
+    // Gaussian kernel (same size and weights as cv::GaussianBlur would use
+    // for a floating point image), only the half starting at the centre is
+    // kept since it is symmetric
+    const int ksize = cvRound(sigma * 4 * 2 + 1) | 1;
+    const int radius = ksize / 2;
+    vector<double> weights(radius + 1);
+    double sum = 0;
+    for (int i = 0; i <= radius; i++) {
+        weights[i] = exp(-(i * i) / (2.0 * sigma * sigma));
+        sum += i == 0 ? weights[i] : 2 * weights[i];
+    }
+    vector<float> kernel(radius + 1);
+    for (int i = 0; i <= radius; i++) {
+        kernel[i] = static_cast<float>(weights[i] / sum);
+    }
+
+    // Reflected column indices for the Sobel operator (column x - 1 is at
+    // index x and column x + 1 is at index x + 2) and for the padding of
+    // the rows fed to the horizontal Gaussian pass
+    vector<int> sobel_columns(cols + 2);
+    for (int i = 0; i < cols + 2; i++) {
+        sobel_columns[i] = Reflect101(i - 1, cols);
+    }
+    vector<int> pad_columns(2 * radius);
+    for (int i = 0; i < radius; i++) {
+        pad_columns[i] = Reflect101(i - radius, cols);
+        pad_columns[radius + i] = Reflect101(cols + i, cols);
+    }
+
+    auto band = [&](const cv::Range& range) {
+        const int padded_cols = cols + 2 * radius;
+        vector<float> padded(3 * padded_cols);
+        float* pa = &padded[0];
+        float* pb = pa + padded_cols;
+        float* pc = pb + padded_cols;
+        vector<float> ring(3 * ksize * cols);
+        vector<float> sums(3 * cols);
+        float* sa = &sums[0];
+        float* sb = sa + cols;
+        float* sc = sb + cols;
+        auto slot = [&](const int v, const int product) {
+            int s = (v - range.start + radius) % ksize;
+            return &ring[(3 * s + product) * cols];
+        };
+
+        for (int v = range.start - radius; v < range.end + radius; v++) {
+            // Gradients and their products for (reflected) row v
+            int y = Reflect101(v, rows);
+            const uchar* p0 = src_gray.ptr<uchar>(Reflect101(y - 1, rows));
+            const uchar* p1 = src_gray.ptr<uchar>(y);
+            const uchar* p2 = src_gray.ptr<uchar>(Reflect101(y + 1, rows));
+            for (int x = 0; x < cols; x++) {
+                int l = sobel_columns[x];
+                int r = sobel_columns[x + 2];
+                float dx = (p0[r] - p0[l]) + 2 * (p1[r] - p1[l]) +
+                           (p2[r] - p2[l]);
+                float dy = (p2[l] + 2 * p2[x] + p2[r]) -
+                           (p0[l] + 2 * p0[x] + p0[r]);
+                pa[radius + x] = dx * dx;
+                pb[radius + x] = dy * dy;
+                pc[radius + x] = dx * dy;
+            }
+            for (int i = 0; i < radius; i++) {
+                int left = pad_columns[i];
+                int right = pad_columns[radius + i];
+                pa[i] = pa[radius + left];
+                pb[i] = pb[radius + left];
+                pc[i] = pc[radius + left];
+                pa[radius + cols + i] = pa[radius + right];
+                pb[radius + cols + i] = pb[radius + right];
+                pc[radius + cols + i] = pc[radius + right];
+            }
+
+            // Horizontal Gaussian pass into the ring buffer
+            float* ha = slot(v, 0);
+            float* hb = slot(v, 1);
+            float* hc = slot(v, 2);
+            for (int x = 0; x < cols; x++) {
+                const int c = radius + x;
+                float a = kernel[0] * pa[c];
+                float b = kernel[0] * pb[c];
+                float cc = kernel[0] * pc[c];
+                for (int i = 1; i <= radius; i++) {
+                    a += kernel[i] * (pa[c - i] + pa[c + i]);
+                    b += kernel[i] * (pb[c - i] + pb[c + i]);
+                    cc += kernel[i] * (pc[c - i] + pc[c + i]);
+                }
+                ha[x] = a;
+                hb[x] = b;
+                hc[x] = cc;
+            }
+
+            // Vertical Gaussian pass and response once the ring holds all
+            // of the rows surrounding the centre row
+            const int r = v - radius;
+            if (r < range.start) {
+                continue;
+            }
+            const float* a0 = slot(r, 0);
+            const float* b0 = slot(r, 1);
+            const float* c0 = slot(r, 2);
+            for (int x = 0; x < cols; x++) {
+                sa[x] = kernel[0] * a0[x];
+                sb[x] = kernel[0] * b0[x];
+                sc[x] = kernel[0] * c0[x];
+            }
+            for (int i = 1; i <= radius; i++) {
+                const float* a_above = slot(r - i, 0);
+                const float* b_above = slot(r - i, 1);
+                const float* c_above = slot(r - i, 2);
+                const float* a_below = slot(r + i, 0);
+                const float* b_below = slot(r + i, 1);
+                const float* c_below = slot(r + i, 2);
+                for (int x = 0; x < cols; x++) {
+                    sa[x] += kernel[i] * (a_above[x] + a_below[x]);
+                    sb[x] += kernel[i] * (b_above[x] + b_below[x]);
+                    sc[x] += kernel[i] * (c_above[x] + c_below[x]);
+                }
+            }
+            float* dst_ptr = dst.ptr<float>(r);
+            for (int x = 0; x < cols; x++) {
+                dst_ptr[x] = response(sa[x], sb[x], sc[x]);
+            }
+        }
+    };
+
+    // Every band recomputes the 2 * radius rows surrounding it, so keep the
+    // bands tall compared to the kernel
+    const int band_rows = max(64, 8 * ksize);
+    cv::parallel_for_(cv::Range(0, rows), band,
+                      max(1, rows / band_rows));
+    return true;
+}
+}
+
 /** Apply the Harris corner detector to a color image
  *
- *  \param[in] src     source cv::Mat of CV_8UC3
+ *  \param[in] src     source cv::Mat of CV_8UC3 or CV_8UC1
  *  \param[out] dst    destination cv:Mat of CV_32FC1
  *  \param[in] sigma   standard deviation of the Gaussian blur kernel
  *  \param[in] k       free parameter in the equation
@@ -26,30 +218,26 @@ namespace ipcv {
  */
 bool Harris(const cv::Mat& src, cv::Mat& dst, const float sigma,
             const float k) {
-    cv::Mat src_gray;
-    cv::cvtColor(src, src_gray, cv::COLOR_BGR2GRAY);
+    return StructureTensorResponse(
+        src, dst, sigma, [k](const float a, const float b, const float c) {
+            float det = a * b - c * c;
+            float tr = a + b;
+            return det - k * tr * tr;
+        });
+}
 
-    dst.create(src_gray.size(), CV_32FC1);
-    // Create the gradient images: A, B, and C
-    cv::Mat Dx, Dy, A, B, C, C2, det, tr2;
-    cv::Sobel(src_gray, Dx, dst.depth(), 1, 0);
-    cv::Sobel(src_gray, Dy, dst.depth(), 0, 1);
-    cv::pow(Dx, 2, A);
-    cv::pow(Dy, 2, B);
-    cv::multiply(Dx, Dy, C);
-    // Apply a blur filter to the gradients to spread out the corner values for easier detections
-    cv::Size_<int> radius(0,0);
-    cv::GaussianBlur(A, A, radius, sigma, sigma);
-    cv::GaussianBlur(B, B, radius, sigma, sigma);
-    cv::GaussianBlur(C, C, radius, sigma, sigma);
-    // Compute the determinant and trace-squared images
-    cv::multiply(A, B, det);
-    cv::pow(C, 2, C2);
-    det -= C2;
-    tr2 = A+B;
-    cv::pow(tr2, 2, tr2);
-    // Compute the corner image by simulating eigenvalue decomp
-    dst = det-k*tr2;
-    return true;
+/** Apply the Shi-Tomasi corner detector to a color image
+ *
+ *  \param[in] src     source cv::Mat of CV_8UC3 or CV_8UC1
+ *  \param[out] dst    destination cv:Mat of CV_32FC1
+ *  \param[in] sigma   standard deviation of the Gaussian blur kernel
+ */
+bool ShiTomasi(const cv::Mat& src, cv::Mat& dst, const float sigma) {
+    return StructureTensorResponse(
+        src, dst, sigma, [](const float a, const float b, const float c) {
+            float half_difference = 0.5f * (a - b);
+            return 0.5f * (a + b) -
+                   sqrt(half_difference * half_difference + c * c);
+        });
 }
 }
@@ -15,11 +15,21 @@ namespace ipcv {
 
 /** Apply the Harris corner detector to a color image
  *
- *  \param[in] src     source cv::Mat of CV_8UC3
+ *  \param[in] src     source cv::Mat of CV_8UC3 or CV_8UC1
  *  \param[out] dst    destination cv:Mat of CV_32FC1
  *  \param[in] sigma   standard deviation of the Gaussian blur kernel
  *  \param[in] k       free parameter in the equation
  *                        dst = (lambda1)(lambda2) - k(lambda1 + lambda2)^2
  */
 bool Harris(const cv::Mat& src, cv::Mat& dst, const float sigma, const float k);
+
+/** Apply the Shi-Tomasi (minimum eigenvalue) corner detector to a color
+ *  image
+ *
+ *  \param[in] src     source cv::Mat of CV_8UC3 or CV_8UC1
+ *  \param[out] dst    destination cv:Mat of CV_32FC1
+ *                        dst = min(lambda1, lambda2)
+ *  \param[in] sigma   standard deviation of the Gaussian blur kernel
+ */
+bool ShiTomasi(const cv::Mat& src, cv::Mat& dst, const float sigma);
 }
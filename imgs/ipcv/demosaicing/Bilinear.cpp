@@ -5,9 +5,16 @@
  *  \date 07 Jan 2019
  */
 
-#include <iostream>
+#include <cstdint>
+#include <vector>
 
-#include <opencv2/imgproc.hpp>
+#include <opencv2/core.hpp>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "Bilinear.h"
 
@@ -15,128 +22,279 @@ using namespace std;
 
 namespace ipcv {
 
-cv::Mat Bilinear(const cv::Mat& src, string pattern) {
-  // Create blue (B) and red (R) filter location masks
-  int b_row;
-  int b_col;
-  int r_row;
-  int r_col;
-  if (pattern == "GBRG") {
-    b_row = 0;
-    b_col = 1;
-    r_row = 1;
-    r_col = 0;
-  } else if (pattern == "GRBG") {
-    b_row = 1;
-    b_col = 0;
-    r_row = 0;
-    r_col = 1;
-  } else if (pattern == "BGGR") {
-    b_row = 0;
-    b_col = 0;
-    r_row = 1;
-    r_col = 1;
-  } else if (pattern == "RGGB") {
-    b_row = 1;
-    b_col = 1;
-    r_row = 0;
-    r_col = 0;
+namespace {
+
+// A source row split into its even and odd columns, element j + 1 holds
+// columns 2 j and 2 j + 1 (elements 0 and quads + 1 are reflected across
+// the image borders)
+struct QuadRow {
+  vector<uint16_t> even;
+  vector<uint16_t> odd;
+};
+
+// Load a source row into a quad row, rows and columns outside of the image
+// are reflected about the border pixel (which preserves the CFA parity)
+void LoadQuadRow(const cv::Mat& src, const int y, QuadRow& row) {
+  const uint16_t* s =
+      src.ptr<uint16_t>(cv::borderInterpolate(y, src.rows,
+                                              cv::BORDER_REFLECT_101));
+  auto reflected = [&](const int x) {
+    return s[cv::borderInterpolate(x, src.cols, cv::BORDER_REFLECT_101)];
+  };
+
+  const int quads = (src.cols + 1) / 2;
+  uint16_t* even = row.even.data() + 1;
+  uint16_t* odd = row.odd.data() + 1;
+  even[-1] = reflected(-2);
+  odd[-1] = reflected(-1);
+  int j = 0;
+  for (; 2 * j + 1 < src.cols; j++) {
+    even[j] = s[2 * j];
+    odd[j] = s[2 * j + 1];
+  }
+  for (; j <= quads; j++) {
+    even[j] = reflected(2 * j);
+    odd[j] = reflected(2 * j + 1);
+  }
+}
+
+// Integer (truncating) averages of one quad at a time
+struct ScalarOps {
+  using Vector = int;
+  static const int width = 1;
+
+  static Vector Load(const uint16_t* p) { return *p; }
+  static void Store(uint16_t* p, const Vector v) {
+    *p = static_cast<uint16_t>(v);
+  }
+  static Vector Average(const Vector a, const Vector b) { return (a + b) / 2; }
+  static Vector Average(const Vector a, const Vector b, const Vector c,
+                        const Vector d) {
+    return (a + b + c + d) / 4;
+  }
+};
+
+#if defined(__AVX2__)
+// Integer (truncating) averages of 16 quads at a time
+struct Avx2Ops {
+  using Vector = __m256i;
+  static const int width = 16;
+
+  static Vector Load(const uint16_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  static void Store(uint16_t* p, const Vector v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+  }
+
+  // floor((a + b) / 2) without overflowing 16 bits
+  static Vector Average(const Vector a, const Vector b) {
+    return _mm256_add_epi16(_mm256_and_si256(a, b),
+                            _mm256_srli_epi16(_mm256_xor_si256(a, b), 1));
+  }
+
+  // floor((a + b + c + d) / 4) with 32-bit sums, unpacking and packing
+  // both work within 128-bit lanes, so the order of the quads is kept
+  static Vector Average(const Vector a, const Vector b, const Vector c,
+                        const Vector d) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_unpacklo_epi16(a, zero),
+                         _mm256_unpacklo_epi16(b, zero)),
+        _mm256_add_epi32(_mm256_unpacklo_epi16(c, zero),
+                         _mm256_unpacklo_epi16(d, zero)));
+    __m256i hi = _mm256_add_epi32(
+        _mm256_add_epi32(_mm256_unpackhi_epi16(a, zero),
+                         _mm256_unpackhi_epi16(b, zero)),
+        _mm256_add_epi32(_mm256_unpackhi_epi16(c, zero),
+                         _mm256_unpackhi_epi16(d, zero)));
+    return _mm256_packus_epi32(_mm256_srli_epi32(lo, 2),
+                               _mm256_srli_epi32(hi, 2));
+  }
+};
+#endif
+
+#if defined(__SSE2__)
+// Integer (truncating) averages of 8 quads at a time
+struct Sse2Ops {
+  using Vector = __m128i;
+  static const int width = 8;
+
+  static Vector Load(const uint16_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+  static void Store(uint16_t* p, const Vector v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+  }
+
+  // floor((a + b) / 2) without overflowing 16 bits
+  static Vector Average(const Vector a, const Vector b) {
+    return _mm_add_epi16(_mm_and_si128(a, b),
+                         _mm_srli_epi16(_mm_xor_si128(a, b), 1));
+  }
+
+  // floor((a + b + c + d) / 4) as the sum of the quarters plus the quarter
+  // of the sum of the remainders, which never exceeds 16 bits (there is no
+  // unsigned 32-bit pack before SSE4.1)
+  static Vector Average(const Vector a, const Vector b, const Vector c,
+                        const Vector d) {
+    const __m128i three = _mm_set1_epi16(3);
+    __m128i quarters = _mm_add_epi16(
+        _mm_add_epi16(_mm_srli_epi16(a, 2), _mm_srli_epi16(b, 2)),
+        _mm_add_epi16(_mm_srli_epi16(c, 2), _mm_srli_epi16(d, 2)));
+    __m128i remainders = _mm_add_epi16(
+        _mm_add_epi16(_mm_and_si128(a, three), _mm_and_si128(b, three)),
+        _mm_add_epi16(_mm_and_si128(c, three), _mm_and_si128(d, three)));
+    return _mm_add_epi16(quarters, _mm_srli_epi16(remainders, 2));
+  }
+};
+#endif
+
+// Even and odd columns of the source rows y0 - 1, y0, y0 + 1 and y0 + 2 of
+// the quads starting at row y0, offset so that index j is quad j
+struct QuadRows {
+  const uint16_t* even[4];
+  const uint16_t* odd[4];
+};
+
+// Channel K at position (DY, DX) of the quads j .. j + width - 1.  Missing
+// green values are the average of the four neighbors, missing blue and red
+// values the average of the horizontal (rows holding samples) or vertical
+// (other rows) neighbors at green locations, and the average of the
+// horizontal averages above and below at the opposite color locations.
+template <typename Ops, typename Pattern, int DY, int DX, int K>
+inline typename Ops::Vector QuadValue(const QuadRows& rows, const int j) {
+  // Center, left and right neighbors within row t of the rows
+  auto center = [&](const int t) {
+    return Ops::Load(DX == 0 ? rows.even[t] + j : rows.odd[t] + j);
+  };
+  auto left = [&](const int t) {
+    return Ops::Load(DX == 0 ? rows.odd[t] + j - 1 : rows.even[t] + j);
+  };
+  auto right = [&](const int t) {
+    return Ops::Load(DX == 0 ? rows.odd[t] + j : rows.even[t] + j + 1);
+  };
+
+  constexpr int channel = Pattern::Channel(DY, DX);
+  constexpr int sample_row = K == 2 ? Pattern::r_row : Pattern::b_row;
+  if constexpr (channel == K) {
+    return center(DY + 1);
+  } else if constexpr (K == 1) {
+    return Ops::Average(center(DY), left(DY + 1), center(DY + 2),
+                        right(DY + 1));
+  } else if constexpr (channel == 1 && sample_row == DY) {
+    return Ops::Average(left(DY + 1), right(DY + 1));
+  } else if constexpr (channel == 1) {
+    return Ops::Average(center(DY), center(DY + 2));
   } else {
-    cerr << "Invalid CFA pattern provided: " << pattern << endl;
-    exit(EXIT_FAILURE);
+    return Ops::Average(Ops::Average(left(DY), right(DY)),
+                        Ops::Average(left(DY + 2), right(DY + 2)));
   }
-  cv::Mat b_mask = cv::Mat::zeros(src.size(), CV_16UC1);
-  for (int r = b_row; r < src.rows; r += 2) {
-    for (int c = b_col; c < src.cols; c += 2) {
-      b_mask.at<uint16_t>(r, c) = 1;
-    }
+}
+
+// Store all 12 values (2 x 2 positions, 3 channels) of the quads j .. j +
+// width - 1, value I = (2 DY + DX) * 3 + K goes to planes[I]
+template <typename Ops, typename Pattern, int I = 0>
+inline void StoreQuads(const QuadRows& rows, const int j,
+                       uint16_t* const* planes) {
+  if constexpr (I < 12) {
+    Ops::Store(planes[I] + j,
+               QuadValue<Ops, Pattern, I / 6, (I / 3) % 2, I % 3>(rows, j));
+    StoreQuads<Ops, Pattern, I + 1>(rows, j, planes);
   }
-  cv::Mat r_mask = cv::Mat::zeros(src.size(), CV_16UC1);
-  for (int r = r_row; r < src.rows; r += 2) {
-    for (int c = r_col; c < src.cols; c += 2) {
-      r_mask.at<uint16_t>(r, c) = 1;
+}
+}
+
+template <typename Pattern>
+cv::Mat Bilinear(const cv::Mat& src) {
+  cv::Mat dst(src.size(), CV_16UC3);
+  const int quads = (src.cols + 1) / 2;
+  const int quad_rows = (src.rows + 1) / 2;
+
+  // Bands of quad rows are interpolated in parallel, every band streams
+  // its source rows through a ring of four quad rows (the rows above,
+  // within and below a row of quads) and interpolates all three channels
+  // of every quad in a single pass
+  cv::parallel_for_(cv::Range(0, quad_rows), [&](const cv::Range& range) {
+    QuadRow ring[4];
+    for (auto& row : ring) {
+      row.even.resize(quads + 2);
+      row.odd.resize(quads + 2);
     }
-  }
 
-  // Create green (G) filter location mask
-  cv::Mat g_mask = cv::Mat::ones(src.size(), CV_16UC1);
-  cv::subtract(g_mask, b_mask, g_mask);
-  cv::subtract(g_mask, r_mask, g_mask);
-
-  // Initialize interpolated B, G, and R channels
-  cv::Mat B;
-  cv::multiply(src, b_mask, B);
-  cv::Mat G;
-  cv::multiply(src, g_mask, G);
-  cv::Mat R;
-  cv::multiply(src, r_mask, R);
-
-  // Set bounds for the iterpolation domain
-  int ul_row = 2;
-  int ul_col = 2;
-  int lr_row = src.rows - 2;
-  int lr_col = src.cols - 2;
-
-  // Interpolate green (G) channel
-  for (int r = ul_row; r < lr_row; r++) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (g_mask.at<uint16_t>(r, c) == 0) {
-        G.at<uint16_t>(r, c) =
-            (G.at<uint16_t>(r - 1, c) + G.at<uint16_t>(r, c - 1) +
-             G.at<uint16_t>(r + 1, c) + G.at<uint16_t>(r, c + 1)) /
-            4;
-      }
+    // One plane of quads per position and channel
+    vector<uint16_t> values(12 * quads);
+    uint16_t* planes[12];
+    for (int i = 0; i < 12; i++) {
+      planes[i] = values.data() + i * quads;
     }
-  }
 
-  // Interpolate missing red (R) values in red (R) rows (horizontal)
-  for (int r = r_row; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (r_mask.at<uint16_t>(r, c) == 0) {
-        R.at<uint16_t>(r, c) =
-            (R.at<uint16_t>(r, c - 1) + R.at<uint16_t>(r, c + 1)) / 2;
-      }
+    for (int y = 2 * range.start - 1; y <= 2 * range.start + 2; y++) {
+      LoadQuadRow(src, y, ring[y & 3]);
     }
-  }
 
-  // Interpolate values in missing red (R) rows (vertical)
-  for (int r = r_row + 1; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (r_mask.at<uint16_t>(r, c) == 0) {
-        R.at<uint16_t>(r, c) =
-            (R.at<uint16_t>(r - 1, c) + R.at<uint16_t>(r + 1, c)) / 2;
+    for (int i = range.start; i < range.end; i++) {
+      const int y0 = 2 * i;
+      if (i > range.start) {
+        LoadQuadRow(src, y0 + 1, ring[(y0 + 1) & 3]);
+        LoadQuadRow(src, y0 + 2, ring[(y0 + 2) & 3]);
       }
-    }
-  }
 
-  // Interpolate missing blue (B) values in blue (B) rows (horizontal)
-  for (int r = b_row; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (b_mask.at<uint16_t>(r, c) == 0) {
-        B.at<uint16_t>(r, c) =
-            (B.at<uint16_t>(r, c - 1) + B.at<uint16_t>(r, c + 1)) / 2;
+      QuadRows rows;
+      for (int t = 0; t < 4; t++) {
+        const QuadRow& row = ring[(y0 - 1 + t) & 3];
+        rows.even[t] = row.even.data() + 1;
+        rows.odd[t] = row.odd.data() + 1;
       }
-    }
-  }
 
-  // Interpolate values in missing blue (B) rows (vertical)
-  for (int r = b_row + 1; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (b_mask.at<uint16_t>(r, c) == 0) {
-        B.at<uint16_t>(r, c) =
-            (B.at<uint16_t>(r - 1, c) + B.at<uint16_t>(r + 1, c)) / 2;
+      int j = 0;
+#if defined(__AVX2__)
+      for (; j + Avx2Ops::width <= quads; j += Avx2Ops::width) {
+        StoreQuads<Avx2Ops, Pattern>(rows, j, planes);
+      }
+#endif
+#if defined(__SSE2__)
+      for (; j + Sse2Ops::width <= quads; j += Sse2Ops::width) {
+        StoreQuads<Sse2Ops, Pattern>(rows, j, planes);
+      }
+#endif
+      for (; j < quads; j++) {
+        StoreQuads<ScalarOps, Pattern>(rows, j, planes);
       }
-    }
-  }
 
-  // Merge the interpolated B, G, and R channels into a 3-channel cv::Mat
-  cv::Mat channels[3];
-  channels[0] = B;
-  channels[1] = G;
-  channels[2] = R;
-  cv::Mat dst;
-  cv::merge(channels, 3, dst);
+      // Interleave the planes into the BGR destination rows
+      for (int dy = 0; dy < 2 && y0 + dy < src.rows; dy++) {
+        const uint16_t* const* even = planes + 6 * dy;
+        const uint16_t* const* odd = even + 3;
+        uint16_t* d = dst.ptr<uint16_t>(y0 + dy);
+        int q = 0;
+        for (; 2 * q + 1 < src.cols; q++, d += 6) {
+          d[0] = even[0][q];
+          d[1] = even[1][q];
+          d[2] = even[2][q];
+          d[3] = odd[0][q];
+          d[4] = odd[1][q];
+          d[5] = odd[2][q];
+        }
+        if (q < quads) {
+          d[0] = even[0][q];
+          d[1] = even[1][q];
+          d[2] = even[2][q];
+        }
+      }
+    }
+  });
 
   return dst;
 }
+
+template cv::Mat Bilinear<CfaGbrg>(const cv::Mat& src);
+template cv::Mat Bilinear<CfaGrbg>(const cv::Mat& src);
+template cv::Mat Bilinear<CfaBggr>(const cv::Mat& src);
+template cv::Mat Bilinear<CfaRggb>(const cv::Mat& src);
+
+cv::Mat Bilinear(const cv::Mat& src, string pattern) {
+  return DispatchCfa(
+      pattern, [&](auto cfa) { return Bilinear<decltype(cfa)>(src); });
+}
 }
@@ -48,6 +48,14 @@
  *    "y" location will be the average of the vertical neighbors (half
  *    of which are original blue values and half of which are interpolated
  *    blue values).
+ *
+ *    All three channels are interpolated in a single pass over the 2 x 2
+ *    quads of the CFA (8 quads at a time with SSE2, the x86-64 default,
+ *    or 16 at a time when built with IMGS_ENABLE_AVX2), and written
+ *    directly to the interleaved destination.  Pixels beyond the
+ *    image are reflected about the border pixel, which preserves the CFA
+ *    parity, so the outer rows and columns are interpolated like any
+ *    other.
  */
 
 #pragma once
@@ -56,6 +64,8 @@
 
 #include <opencv2/core.hpp>
 
+#include "imgs/ipcv/demosaicing/CfaPattern.h"
+
 using namespace std;
 
 namespace ipcv {
@@ -77,4 +87,16 @@ namespace ipcv {
  *                       3-channel (color) image
  */
 cv::Mat Bilinear(const cv::Mat& src, string pattern = "GBRG");
+
+/** Interpolate CFA using bilinear interpolation, specialized for a CFA
+ *  pattern
+ *
+ *  \tparam Pattern      CFA layout (CfaGbrg, CfaGrbg, CfaBggr or CfaRggb)
+ *  \param[in] src       source cv::Mat of CV_16UC1 containing CFA
+ *
+ *  \return              destination cv::Mat of CV_16UC3 for interpolated
+ *                       3-channel (color) image
+ */
+template <typename Pattern>
+cv::Mat Bilinear(const cv::Mat& src);
 }
@@ -0,0 +1,83 @@
+/** Interface file for compile-time Bayer CFA pattern descriptions
+ *
+ *  \file ipcv/demosaic/CfaPattern.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    The demosaicers are templated on the CFA pattern, so that the channel
+ *    sampled at a location and the columns holding the blue and red
+ *    samples of a row are resolved at compile time.  No mask images are
+ *    built; the samples are scattered into their channels directly and
+ *    the interpolation loops step over exactly the locations they fill.
+ *    The pattern string API dispatches once to the specialized kernel.
+ */
+
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/** Bayer CFA layout, given by the parities of the row and column of the
+ *  blue (B) and of the red (R) sample of every 2 x 2 cell
+ */
+template <int BRow, int BCol, int RRow, int RCol>
+struct CfaPattern {
+  static constexpr int b_row = BRow;
+  static constexpr int b_col = BCol;
+  static constexpr int r_row = RRow;
+  static constexpr int r_col = RCol;
+
+  /// Channel (0 = B, 1 = G, 2 = R) sampled at a location
+  static constexpr int Channel(const int r, const int c) {
+    return ((r & 1) == b_row && (c & 1) == b_col)
+               ? 0
+               : ((r & 1) == r_row && (c & 1) == r_col) ? 2 : 1;
+  }
+
+  /// Parity of the columns holding the blue or red samples of a row (the
+  /// other columns of the row hold green samples)
+  static constexpr int ColorColumn(const int r) {
+    return (r & 1) == b_row ? b_col : r_col;
+  }
+};
+
+using CfaGbrg = CfaPattern<0, 1, 1, 0>;
+using CfaGrbg = CfaPattern<1, 0, 0, 1>;
+using CfaBggr = CfaPattern<0, 0, 1, 1>;
+using CfaRggb = CfaPattern<1, 1, 0, 0>;
+
+/** First index at or after start of the provided parity
+ */
+constexpr int FirstOfParity(const int start, const int parity) {
+  return start + ((start ^ parity) & 1);
+}
+
+/** Call a kernel for the CFA pattern named by a string
+ *
+ *  \param[in] pattern  'GBRG', 'GRBG', 'BGGR' or 'RGGB'
+ *  \param[in] kernel   callable taking a pattern (CfaGbrg, CfaGrbg,
+ *                      CfaBggr or CfaRggb) by value
+ *
+ *  \return             the result of the kernel
+ */
+template <typename Kernel>
+cv::Mat DispatchCfa(const std::string& pattern, Kernel kernel) {
+  if (pattern == "GBRG") {
+    return kernel(CfaGbrg());
+  } else if (pattern == "GRBG") {
+    return kernel(CfaGrbg());
+  } else if (pattern == "BGGR") {
+    return kernel(CfaBggr());
+  } else if (pattern == "RGGB") {
+    return kernel(CfaRggb());
+  }
+  std::cerr << "Invalid CFA pattern provided: " << pattern << std::endl;
+  exit(EXIT_FAILURE);
+}
+}
@@ -8,5 +8,6 @@
 #pragma once
 
 #include "imgs/ipcv/demosaicing/Bilinear.h"
+#include "imgs/ipcv/demosaicing/CfaPattern.h"
 #include "imgs/ipcv/demosaicing/LarochePrescott.h"
 #include "imgs/ipcv/demosaicing/Homogeneity.h"
@@ -13,7 +13,7 @@
 
 #include "imgs/ipcv/utils/Utils.h"
 
-#include "Bilinear.h"
+#include "Homogeneity.h"
 
 using namespace std;
 
@@ -28,62 +28,20 @@ double medianMat(cv::Mat Input){
     return vecFromMat[(vecFromMat.size()-1)/2]; // odd-number of elements in matrix
 }
 
-cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
-    // Create blue (B) and red (R) filter location masks
-    int b_row;
-    int b_col;
-    int r_row;
-    int r_col;
-    if (pattern == "GBRG") {
-        b_row = 0;
-        b_col = 1;
-        r_row = 1;
-        r_col = 0;
-        } else if (pattern == "GRBG") {
-        b_row = 1;
-        b_col = 0;
-        r_row = 0;
-        r_col = 1;
-        } else if (pattern == "BGGR") {
-        b_row = 0;
-        b_col = 0;
-        r_row = 1;
-        r_col = 1;
-        } else if (pattern == "RGGB") {
-        b_row = 1;
-        b_col = 1;
-        r_row = 0;
-        r_col = 0;
-    }
-    else {
-        cerr << "Invalid CFA pattern provided: " << pattern << endl;
-        exit(EXIT_FAILURE);
-    }
-    cv::Mat b_mask = cv::Mat::zeros(src.size(), CV_16UC1);
-    for (int r = b_row; r < src.rows; r += 2) {
-        for (int c = b_col; c < src.cols; c += 2) {
-          b_mask.at<uint16_t>(r, c) = 1;
+template <typename Pattern>
+cv::Mat Homogeneity(const cv::Mat& src) {
+    // Scatter the CFA samples into the B, G, and R channels, the missing
+    // values start out as zero
+    cv::Mat B = cv::Mat::zeros(src.size(), CV_32FC1);
+    cv::Mat G = cv::Mat::zeros(src.size(), CV_32FC1);
+    cv::Mat R = cv::Mat::zeros(src.size(), CV_32FC1);
+    for (int r = 0; r < src.rows; r++) {
+        const uint16_t* s = src.ptr<uint16_t>(r);
+        float* bgr[3] = {B.ptr<float>(r), G.ptr<float>(r), R.ptr<float>(r)};
+        for (int c = 0; c < src.cols; c++) {
+            bgr[Pattern::Channel(r, c)][c] = s[c];
         }
     }
-  cv::Mat r_mask = cv::Mat::zeros(src.size(), CV_16UC1);
-  for (int r = r_row; r < src.rows; r += 2) {
-    for (int c = r_col; c < src.cols; c += 2) {
-      r_mask.at<uint16_t>(r, c) = 1;
-    }
-  }
-
-  // Create green (G) filter location mask
-  cv::Mat g_mask = cv::Mat::ones(src.size(), CV_16UC1);
-  cv::subtract(g_mask, b_mask, g_mask);
-  cv::subtract(g_mask, r_mask, g_mask);
-
-  // Initialize interpolated B, G, and R channels
-  cv::Mat B;
-  cv::multiply(src, b_mask, B, 1, CV_32FC1);
-  cv::Mat G;
-  cv::multiply(src, g_mask, G, 1, CV_32FC1);
-  cv::Mat R;
-  cv::multiply(src, r_mask, R, 1, CV_32FC1);
     
     // Split the green channel into even and odd columns
     cv::Mat G0Hor = cv::Mat::zeros(src.size(), CV_32FC1);
@@ -122,26 +80,28 @@ cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
     cv::Mat Ghor = GhorBlue + GhorRed;
     
     // Create the red interpolated image in the horizonal direction
-    cv::multiply(Ghor, r_mask, Gs, 1, CV_32FC1);
+    Gs = cv::Mat::zeros(src.size(), CV_32FC1);
+    for (int r = Pattern::r_row; r < src.rows; r += 2) {
+        for (int c = Pattern::r_col; c < src.cols; c += 2) {
+            Gs.at<float>(r, c) = Ghor.at<float>(r, c);
+        }
+    }
     Rhor = R-Gs;
     // Set bounds for the iterpolation domain
     int ul_col = 2;
     int lr_row = src.rows - 2;
     int lr_col = src.cols - 2;
-    for (int r = r_row; r < lr_row; r += 2) {
-        for (int c = ul_col; c < lr_col; c++) {
-            if (r_mask.at<uint16_t>(r, c) == 0) {
-                Rhor.at<float>(r, c) =
-                (Rhor.at<float>(r, c - 1) + Rhor.at<float>(r, c + 1)) / 2;
-            }
+    for (int r = Pattern::r_row; r < lr_row; r += 2) {
+        for (int c = FirstOfParity(ul_col, Pattern::r_col ^ 1); c < lr_col;
+             c += 2) {
+            Rhor.at<float>(r, c) =
+            (Rhor.at<float>(r, c - 1) + Rhor.at<float>(r, c + 1)) / 2;
         }
     }
-    for (int r = r_row + 1; r < lr_row; r += 2) {
+    for (int r = Pattern::r_row + 1; r < lr_row; r += 2) {
         for (int c = ul_col; c < lr_col; c++) {
-            if (r_mask.at<uint16_t>(r, c) == 0) {
-                Rhor.at<float>(r, c) =
-                (Rhor.at<float>(r - 1, c) + Rhor.at<float>(r + 1, c)) / 2;
-            }
+            Rhor.at<float>(r, c) =
+            (Rhor.at<float>(r - 1, c) + Rhor.at<float>(r + 1, c)) / 2;
         }
     }
     Rhor += Ghor;
@@ -149,21 +109,18 @@ cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
     // Create the blue interpolated image in the horizonal direction
     Gs = filterH1G1 + filterH0B;
     Bhor = B-Gs;
-    for (int r = b_row; r < lr_row; r += 2) {
-        for (int c = ul_col; c < lr_col; c++) {
-            if (b_mask.at<uint16_t>(r, c) == 0) {
-                Bhor.at<float>(r, c) =
-                (Bhor.at<float>(r, c - 1) + Bhor.at<float>(r, c + 1)) / 2;
-            }
+    for (int r = Pattern::b_row; r < lr_row; r += 2) {
+        for (int c = FirstOfParity(ul_col, Pattern::b_col ^ 1); c < lr_col;
+             c += 2) {
+            Bhor.at<float>(r, c) =
+            (Bhor.at<float>(r, c - 1) + Bhor.at<float>(r, c + 1)) / 2;
         }
     }
     
-    for (int r = b_row + 1; r < lr_row; r += 2) {
+    for (int r = Pattern::b_row + 1; r < lr_row; r += 2) {
         for (int c = ul_col; c < lr_col; c++) {
-            if (b_mask.at<uint16_t>(r, c) == 0) {
-                Bhor.at<float>(r, c) =
-                (Bhor.at<float>(r - 1, c) + Bhor.at<float>(r + 1, c)) / 2;
-            }
+            Bhor.at<float>(r, c) =
+            (Bhor.at<float>(r - 1, c) + Bhor.at<float>(r + 1, c)) / 2;
         }
     }
     Bhor += Ghor;
@@ -189,20 +146,17 @@ cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
     cv::Mat Rvert, Bvert;
     Gs = filterH1G1 + filterH0R;
     Rvert = R-Gs;
-    for (int r = r_row; r < lr_row; r += 2) {
-        for (int c = ul_col; c < lr_col; c++) {
-            if (r_mask.at<uint16_t>(r, c) == 0) {
-                Rvert.at<float>(r, c) =
-                (Rvert.at<float>(r, c - 1) + Rvert.at<float>(r, c + 1)) / 2;
-            }
+    for (int r = Pattern::r_row; r < lr_row; r += 2) {
+        for (int c = FirstOfParity(ul_col, Pattern::r_col ^ 1); c < lr_col;
+             c += 2) {
+            Rvert.at<float>(r, c) =
+            (Rvert.at<float>(r, c - 1) + Rvert.at<float>(r, c + 1)) / 2;
         }
     }
-    for (int r = r_row + 1; r < lr_row; r += 2) {
+    for (int r = Pattern::r_row + 1; r < lr_row; r += 2) {
         for (int c = ul_col; c < lr_col; c++) {
-            if (r_mask.at<uint16_t>(r, c) == 0) {
-                Rvert.at<float>(r, c) =
-                (Rvert.at<float>(r - 1, c) + Rvert.at<float>(r + 1, c)) / 2;
-            }
+            Rvert.at<float>(r, c) =
+            (Rvert.at<float>(r - 1, c) + Rvert.at<float>(r + 1, c)) / 2;
         }
     }
     Rvert += Gvert;
@@ -210,21 +164,18 @@ cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
     // Create the blue interpolated image in the vertical direction
     Gs = filterH1G0 + filterH0B;
     Bvert = B-Gs;
-    for (int r = b_row; r < lr_row; r += 2) {
-        for (int c = ul_col; c < lr_col; c++) {
-            if (b_mask.at<uint16_t>(r, c) == 0) {
-                Bvert.at<float>(r, c) =
-                (Bvert.at<float>(r, c - 1) + Bvert.at<float>(r, c + 1)) / 2;
-            }
+    for (int r = Pattern::b_row; r < lr_row; r += 2) {
+        for (int c = FirstOfParity(ul_col, Pattern::b_col ^ 1); c < lr_col;
+             c += 2) {
+            Bvert.at<float>(r, c) =
+            (Bvert.at<float>(r, c - 1) + Bvert.at<float>(r, c + 1)) / 2;
         }
     }
     
-    for (int r = b_row + 1; r < lr_row; r += 2) {
+    for (int r = Pattern::b_row + 1; r < lr_row; r += 2) {
         for (int c = ul_col; c < lr_col; c++) {
-            if (b_mask.at<uint16_t>(r, c) == 0) {
-                Bvert.at<float>(r, c) =
-                (Bvert.at<float>(r - 1, c) + Bvert.at<float>(r + 1, c)) / 2;
-            }
+            Bvert.at<float>(r, c) =
+            (Bvert.at<float>(r - 1, c) + Bvert.at<float>(r + 1, c)) / 2;
         }
     }
     Bvert += Gvert;
@@ -246,12 +197,11 @@ cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
     cv::copyMakeBorder(Hor, tempHor, filterRadius, filterRadius, filterRadius, filterRadius, cv::BORDER_CONSTANT);
     cv::copyMakeBorder(Vert, tempVert, filterRadius, filterRadius, filterRadius, filterRadius, cv::BORDER_CONSTANT);
 
-    cv::cvtColor(tempHor, tempHor, cv::COLOR_BGR2Lab);
-    cv::cvtColor(tempVert, tempVert, cv::COLOR_BGR2Lab);
-    // Create a copy of the src image in the Lab colorspace
+    // Convert the padded images to Lab in a single pass (values are taken
+    // as [0, 1] like cv::cvtColor does for float images)
+    ipcv::BgrToLab(tempHor, tempHor, 1);
+    ipcv::BgrToLab(tempVert, tempVert, 1);
     cv::Rect r;
-    tempHor.convertTo(tempHor, CV_32FC3);
-    tempVert.convertTo(tempVert, CV_32FC3);
     // Split the Lab image into 3 seperate images
     cv::Mat LabHor[3];
     cv::split(tempHor, LabHor);
@@ -346,4 +296,14 @@ cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
 
   return dst;
 }
+
+template cv::Mat Homogeneity<CfaGbrg>(const cv::Mat& src);
+template cv::Mat Homogeneity<CfaGrbg>(const cv::Mat& src);
+template cv::Mat Homogeneity<CfaBggr>(const cv::Mat& src);
+template cv::Mat Homogeneity<CfaRggb>(const cv::Mat& src);
+
+cv::Mat Homogeneity(const cv::Mat& src, string pattern) {
+    return DispatchCfa(
+        pattern, [&](auto cfa) { return Homogeneity<decltype(cfa)>(src); });
+}
 }
@@ -57,6 +57,8 @@
 
 #include <opencv2/core.hpp>
 
+#include "imgs/ipcv/demosaicing/CfaPattern.h"
+
 using namespace std;
 
 namespace ipcv {
@@ -78,4 +80,16 @@ namespace ipcv {
  *                       3-channel (color) image
  */
 cv::Mat Homogeneity(const cv::Mat& src, string pattern = "GBRG");
+
+/** Interpolate CFA using homogeneity-directed interpolation, specialized
+ *  for a CFA pattern
+ *
+ *  \tparam Pattern      CFA layout (CfaGbrg, CfaGrbg, CfaBggr or CfaRggb)
+ *  \param[in] src       source cv::Mat of CV_16UC1 containing CFA
+ *
+ *  \return              destination cv::Mat of CV_32FC3 for interpolated
+ *                       3-channel (color) image
+ */
+template <typename Pattern>
+cv::Mat Homogeneity(const cv::Mat& src);
 }
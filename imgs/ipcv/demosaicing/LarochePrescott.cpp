@@ -6,201 +6,130 @@
  *  \date 07 Jan 2019
  */
 
-#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 
-#include <opencv2/imgproc.hpp>
+#include <opencv2/core.hpp>
 
-#include "Bilinear.h"
+#include "LarochePrescott.h"
 
 using namespace std;
 
 namespace ipcv {
 
-cv::Mat LarochePrescott(const cv::Mat& src, string pattern, int max_value) {
-  // Create blue (B) and red (R) filter location masks
-  int b_row;
-  int b_col;
-  int r_row;
-  int r_col;
-  if (pattern == "GBRG") {
-    b_row = 0;
-    b_col = 1;
-    r_row = 1;
-    r_col = 0;
-  } else if (pattern == "GRBG") {
-    b_row = 1;
-    b_col = 0;
-    r_row = 0;
-    r_col = 1;
-  } else if (pattern == "BGGR") {
-    b_row = 0;
-    b_col = 0;
-    r_row = 1;
-    r_col = 1;
-  } else if (pattern == "RGGB") {
-    b_row = 1;
-    b_col = 1;
-    r_row = 0;
-    r_col = 0;
-  } else {
-    cerr << "Invalid CFA pattern provided: " << pattern << endl;
-    exit(EXIT_FAILURE);
-  }
-  cv::Mat b_mask = cv::Mat::zeros(src.size(), CV_16UC1);
-  for (int r = b_row; r < src.rows; r += 2) {
-    for (int c = b_col; c < src.cols; c += 2) {
-      b_mask.at<uint16_t>(r, c) = 1;
-    }
-  }
-  cv::Mat r_mask = cv::Mat::zeros(src.size(), CV_16UC1);
-  for (int r = r_row; r < src.rows; r += 2) {
-    for (int c = r_col; c < src.cols; c += 2) {
-      r_mask.at<uint16_t>(r, c) = 1;
+template <typename Pattern>
+cv::Mat LarochePrescott(const cv::Mat& src, int max_value) {
+  // Scatter the CFA samples into their B, G, and R channels, the missing
+  // values start out as zero
+  cv::Mat bgr(src.size(), CV_32FC3);
+  for (int r = 0; r < src.rows; r++) {
+    const uint16_t* s = src.ptr<uint16_t>(r);
+    cv::Vec3f* d = bgr.ptr<cv::Vec3f>(r);
+    for (int c = 0; c < src.cols; c++) {
+      d[c] = cv::Vec3f(0, 0, 0);
+      d[c][Pattern::Channel(r, c)] = static_cast<float>(s[c]);
     }
   }
 
-  // Create green (G) filter location mask
-  cv::Mat g_mask = cv::Mat::ones(src.size(), CV_16UC1);
-  cv::subtract(g_mask, b_mask, g_mask);
-  cv::subtract(g_mask, r_mask, g_mask);
-
-  // Initialize interpolated B, G, and R channels
-  cv::Mat B;
-  cv::multiply(src, b_mask, B, 1, CV_32F);
-  cv::Mat G;
-  cv::multiply(src, g_mask, G, 1, CV_32F);
-  cv::Mat R;
-  cv::multiply(src, r_mask, R, 1, CV_32F);
-
   // Set bounds for the iterpolation domain
   int ul_row = 2;
   int ul_col = 2;
   int lr_row = src.rows - 2;
   int lr_col = src.cols - 2;
 
-  // Compute vertical (alpha) and horizontal (beta) edge classifiers
-  // (compute for all locations here and use appropriate ones later)
-  cv::Mat alpha = cv::Mat::zeros(src.size(), CV_32F);
-  cv::Mat beta = cv::Mat::zeros(src.size(), CV_32F);
+  // Interpolate green (G) channel according to gradient rules, the
+  // vertical (alpha) and horizontal (beta) edge classifiers are computed
+  // at the blue (B) and red (R) locations only
   for (int r = ul_row; r < lr_row; r++) {
-    for (int c = ul_col; c < lr_col; c++) {
-      alpha.at<float>(r, c) =
-          abs((static_cast<float>(src.at<uint16_t>(r, c - 2)) +
-               static_cast<float>(src.at<uint16_t>(r, c + 2))) /
-                  2 -
-              static_cast<float>(src.at<uint16_t>(r, c)));
-      beta.at<float>(r, c) =
-          abs((static_cast<float>(src.at<uint16_t>(r - 2, c)) +
-               static_cast<float>(src.at<uint16_t>(r - 2, c))) /
-                  2 -
-              static_cast<float>(src.at<uint16_t>(r, c)));
-    }
-  }
-
-  // Interpolate green (G) channel according to gradient rules
-  for (int r = ul_row; r < lr_row; r++) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (g_mask.at<uint16_t>(r, c) == 0) {
-        float equality_tolerance = 8.0;
-        if (abs(alpha.at<float>(r, c) - beta.at<float>(r, c)) <
-            equality_tolerance) {
-          G.at<float>(r, c) =
-              (G.at<float>(r - 1, c) + 
-               G.at<float>(r, c - 1) +
-               G.at<float>(r + 1, c) + 
-               G.at<float>(r, c + 1)) / 4;
-        } else if (alpha.at<float>(r, c) < beta.at<float>(r, c)) {
-          G.at<float>(r, c) =
-              (G.at<float>(r, c - 1) + G.at<float>(r, c + 1)) / 2;
-        } else if (alpha.at<float>(r, c) > beta.at<float>(r, c)) {
-          G.at<float>(r, c) =
-              (G.at<float>(r - 1, c) + G.at<float>(r + 1, c)) / 2;
-        }
-      }
-    }
-  }
-
-  // Interpolate missing red (R) values in red (R) rows (horizontal)
-  for (int r = r_row; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (g_mask.at<uint16_t>(r, c) == 1) {
-        R.at<float>(r, c) =
-            ((R.at<float>(r, c - 1) - G.at<float>(r, c - 1)) +
-             (R.at<float>(r, c + 1) - G.at<float>(r, c + 1))) / 2 +
-            G.at<float>(r, c);
+    const uint16_t* s = src.ptr<uint16_t>(r);
+    const uint16_t* s_above = src.ptr<uint16_t>(r - 2);
+    const cv::Vec3f* above = bgr.ptr<cv::Vec3f>(r - 1);
+    cv::Vec3f* d = bgr.ptr<cv::Vec3f>(r);
+    const cv::Vec3f* below = bgr.ptr<cv::Vec3f>(r + 1);
+    for (int c = FirstOfParity(ul_col, Pattern::ColorColumn(r)); c < lr_col;
+         c += 2) {
+      float alpha = abs((static_cast<float>(s[c - 2]) +
+                         static_cast<float>(s[c + 2])) /
+                            2 -
+                        static_cast<float>(s[c]));
+      float beta = abs((static_cast<float>(s_above[c]) +
+                        static_cast<float>(s_above[c])) /
+                           2 -
+                       static_cast<float>(s[c]));
+      float equality_tolerance = 8.0;
+      if (abs(alpha - beta) < equality_tolerance) {
+        d[c][1] = (above[c][1] + d[c - 1][1] + below[c][1] + d[c + 1][1]) / 4;
+      } else if (alpha < beta) {
+        d[c][1] = (d[c - 1][1] + d[c + 1][1]) / 2;
+      } else if (alpha > beta) {
+        d[c][1] = (above[c][1] + below[c][1]) / 2;
       }
     }
   }
 
-  // Interpolate missing red (R) values in blue (B) rows (vertical)
-  for (int r = b_row; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (g_mask.at<uint16_t>(r, c) == 1) {
-        R.at<float>(r, c) =
-            ((R.at<float>(r - 1, c) - G.at<float>(r - 1, c)) +
-             (R.at<float>(r + 1, c) - G.at<float>(r + 1, c))) / 2 +
-            G.at<float>(r, c);
-      } else {
-        R.at<float>(r, c) =
-            ((R.at<float>(r - 1, c - 1) - G.at<float>(r - 1, c - 1)) +
-             (R.at<float>(r - 1, c + 1) - G.at<float>(r - 1, c + 1)) +
-             (R.at<float>(r + 1, c - 1) - G.at<float>(r + 1, c - 1)) +
-             (R.at<float>(r + 1, c + 1) - G.at<float>(r + 1, c + 1))) / 4 +
-            G.at<float>(r, c);
+  // Interpolate the blue (k = 0) and red (k = 2) channels from their
+  // differences to the green (G) channel
+  auto interpolate = [&](const int k, const int row, const int col) {
+    // Interpolate missing values in rows holding samples (horizontal)
+    for (int r = row; r < lr_row; r += 2) {
+      cv::Vec3f* d = bgr.ptr<cv::Vec3f>(r);
+      for (int c = FirstOfParity(ul_col, col ^ 1); c < lr_col; c += 2) {
+        d[c][k] = ((d[c - 1][k] - d[c - 1][1]) +
+                   (d[c + 1][k] - d[c + 1][1])) / 2 +
+                  d[c][1];
       }
     }
-  }
 
-  // Interpolate missing blue (B) values in blue (B) rows (horizontal)
-  for (int r = b_row; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (g_mask.at<uint16_t>(r, c) == 1) {
-        B.at<float>(r, c) =
-            ((B.at<float>(r, c - 1) - G.at<float>(r, c - 1)) +
-             (B.at<float>(r, c + 1) - G.at<float>(r, c + 1))) / 2 +
-            G.at<float>(r, c);
+    // Interpolate values in rows without samples (vertical at the green
+    // locations, diagonal at the others), the first row has no row above
+    for (int r = FirstOfParity(1, row ^ 1); r < lr_row; r += 2) {
+      const cv::Vec3f* above = bgr.ptr<cv::Vec3f>(r - 1);
+      cv::Vec3f* d = bgr.ptr<cv::Vec3f>(r);
+      const cv::Vec3f* below = bgr.ptr<cv::Vec3f>(r + 1);
+      for (int c = ul_col; c < lr_col; c++) {
+        if ((c & 1) != Pattern::ColorColumn(r)) {
+          d[c][k] = ((above[c][k] - above[c][1]) +
+                     (below[c][k] - below[c][1])) / 2 +
+                    d[c][1];
+        } else {
+          d[c][k] = ((above[c - 1][k] - above[c - 1][1]) +
+                     (above[c + 1][k] - above[c + 1][1]) +
+                     (below[c - 1][k] - below[c - 1][1]) +
+                     (below[c + 1][k] - below[c + 1][1])) / 4 +
+                    d[c][1];
+        }
       }
     }
-  }
-
-  // Interpolate missing blue (B) values in red (R) rows (vertical)
-  for (int r = r_row; r < lr_row; r += 2) {
-    for (int c = ul_col; c < lr_col; c++) {
-      if (g_mask.at<uint16_t>(r, c) == 1) {
-        B.at<float>(r, c) =
-            ((B.at<float>(r - 1, c) - G.at<float>(r - 1, c)) +
-             (B.at<float>(r + 1, c) - G.at<float>(r + 1, c))) / 2 +
-            G.at<float>(r, c);
-      } else {
-        B.at<float>(r, c) =
-            ((B.at<float>(r - 1, c - 1) - G.at<float>(r - 1, c - 1)) +
-             (B.at<float>(r - 1, c + 1) - G.at<float>(r - 1, c + 1)) +
-             (B.at<float>(r + 1, c - 1) - G.at<float>(r + 1, c - 1)) +
-             (B.at<float>(r + 1, c + 1) - G.at<float>(r + 1, c + 1))) / 4 +
-            G.at<float>(r, c);
-      }
-    }
-  }
+  };
+  interpolate(2, Pattern::r_row, Pattern::r_col);
+  interpolate(0, Pattern::b_row, Pattern::b_col);
 
   // Clamp values into the user-specified dynamic range
   float min_dc = 0.0;
   float max_dc = static_cast<float>(max_value);
+  cv::Mat dst(src.size(), CV_16UC3);
   for (int r = 0; r < src.rows; r++) {
+    const cv::Vec3f* p = bgr.ptr<cv::Vec3f>(r);
+    cv::Vec3w* d = dst.ptr<cv::Vec3w>(r);
     for (int c = 0; c < src.cols; c++) {
-      B.at<float>(r, c) = clamp(B.at<float>(r, c), min_dc, max_dc);
-      G.at<float>(r, c) = clamp(G.at<float>(r, c), min_dc, max_dc);
-      R.at<float>(r, c) = clamp(R.at<float>(r, c), min_dc, max_dc);
+      for (int k = 0; k < 3; k++) {
+        d[c][k] = cv::saturate_cast<uint16_t>(clamp(p[c][k], min_dc, max_dc));
+      }
     }
   }
 
-  // Merge the interpolated B, G, and R channels into a 3-channel cv::Mat
-  cv::Mat channels[3];
-  B.convertTo(channels[0], CV_16U);
-  G.convertTo(channels[1], CV_16U);
-  R.convertTo(channels[2], CV_16U);
-  cv::Mat dst;
-  cv::merge(channels, 3, dst);
-
   return dst;
 }
+
+template cv::Mat LarochePrescott<CfaGbrg>(const cv::Mat& src, int max_value);
+template cv::Mat LarochePrescott<CfaGrbg>(const cv::Mat& src, int max_value);
+template cv::Mat LarochePrescott<CfaBggr>(const cv::Mat& src, int max_value);
+template cv::Mat LarochePrescott<CfaRggb>(const cv::Mat& src, int max_value);
+
+cv::Mat LarochePrescott(const cv::Mat& src, string pattern, int max_value) {
+  return DispatchCfa(pattern, [&](auto cfa) {
+    return LarochePrescott<decltype(cfa)>(src, max_value);
+  });
+}
 }
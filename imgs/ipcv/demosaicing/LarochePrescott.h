@@ -23,6 +23,8 @@
 
 #include <opencv2/core.hpp>
 
+#include "imgs/ipcv/demosaicing/CfaPattern.h"
+
 using namespace std;
 
 namespace ipcv {
@@ -46,4 +48,17 @@ namespace ipcv {
  */
 cv::Mat LarochePrescott(const cv::Mat& src, string pattern = "GBRG",
                         int max_value = 65535);
+
+/** Interpolate CFA using Laroche and Prescott interpolation, specialized
+ *  for a CFA pattern
+ *
+ *  \tparam Pattern        CFA layout (CfaGbrg, CfaGrbg, CfaBggr or CfaRggb)
+ *  \param[in] src         source cv::Mat of CV_16UC1 containing CFA
+ *  \param[in] max_value   the maximum value the image may take on
+ *
+ *  \return                destination cv::Mat of CV_16UC3 for interpolated
+ *                         3-channel (color) image
+ */
+template <typename Pattern>
+cv::Mat LarochePrescott(const cv::Mat& src, int max_value = 65535);
 }
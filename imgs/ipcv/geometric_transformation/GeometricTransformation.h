@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "imgs/ipcv/geometric_transformation/MapCache.h"
 #include "imgs/ipcv/geometric_transformation/MapGCP.h"
 #include "imgs/ipcv/geometric_transformation/MapQ2Q.h"
 #include "imgs/ipcv/geometric_transformation/MapRST.h"
@@ -0,0 +1,271 @@
+/** Implementation file for memoizing remapping coordinate maps
+ *
+ *  \file ipcv/geometric_transformation/MapCache.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "MapCache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+// On-disk layout: header, key (padded so the map data is 16-byte aligned),
+// map1 and map2 as contiguous CV_32FC1 rows
+const char kMagic[8] = {'I', 'P', 'C', 'V', 'M', 'A', 'P', '1'};
+
+struct FileHeader {
+  char magic[8];
+  uint32_t rows;
+  uint32_t cols;
+  uint32_t key_length;
+  uint32_t reserved;
+};
+
+size_t DataOffset(const size_t key_length) {
+  size_t offset = sizeof(FileHeader) + key_length;
+  return (offset + 15) & ~static_cast<size_t>(15);
+}
+
+// 64-bit FNV-1a hash used to name the cache files
+uint64_t Fnv1a(const string& s) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : s) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+}
+
+double MapCacheStatistics::HitRate() const {
+  size_t lookups = memory_hits + disk_hits + misses;
+  if (lookups == 0) {
+    return 0;
+  }
+  return static_cast<double>(memory_hits + disk_hits) / lookups;
+}
+
+string MapCacheKey(const string& transform, const vector<double>& parameters,
+                   const cv::Size& src_size, const cv::Size& dst_size) {
+  ostringstream key;
+  key << transform << ";" << src_size.width << "x" << src_size.height << ";"
+      << dst_size.width << "x" << dst_size.height;
+  key << setprecision(numeric_limits<double>::max_digits10);
+  for (const auto& parameter : parameters) {
+    key << ";" << parameter;
+  }
+  return key.str();
+}
+
+MapCache::MapCache(const size_t capacity, const string& directory)
+    : capacity_(capacity), directory_(directory) {
+  if (!directory_.empty()) {
+    boost::system::error_code error;
+    boost::filesystem::create_directories(directory_, error);
+    if (error) {
+      cerr << "Map cache directory could not be created: " << directory_
+           << endl;
+      directory_.clear();
+    }
+  }
+}
+
+bool MapCache::Lookup(const string& key, cv::Mat& map1, cv::Mat& map2) {
+  {
+    lock_guard<mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      Touch(it->second);
+      it->second->second.map1.copyTo(map1);
+      it->second->second.map2.copyTo(map2);
+      statistics_.memory_hits++;
+      return true;
+    }
+  }
+
+  // Read a previously stored file outside of the lock
+  Entry entry;
+  bool loaded = !directory_.empty() && Load(key, entry);
+
+  lock_guard<mutex> lock(mutex_);
+  if (!loaded) {
+    statistics_.misses++;
+    return false;
+  }
+  statistics_.disk_hits++;
+  Remember(key, entry);
+  entry.map1.copyTo(map1);
+  entry.map2.copyTo(map2);
+  return true;
+}
+
+void MapCache::Insert(const string& key, const cv::Mat& map1,
+                      const cv::Mat& map2) {
+  // Keep a private copy so later changes to the caller's maps cannot leak
+  // into the cache
+  Entry entry;
+  map1.convertTo(entry.map1, CV_32F);
+  map2.convertTo(entry.map2, CV_32F);
+
+  if (!directory_.empty() && !Store(key, entry)) {
+    cerr << "Map cache entry could not be written to: " << Filename(key)
+         << endl;
+  }
+
+  lock_guard<mutex> lock(mutex_);
+  Remember(key, entry);
+}
+
+bool MapCache::Get(const string& key,
+                   const function<bool(cv::Mat&, cv::Mat&)>& compute,
+                   cv::Mat& map1, cv::Mat& map2) {
+  if (Lookup(key, map1, map2)) {
+    return true;
+  }
+  if (!compute(map1, map2)) {
+    return false;
+  }
+  Insert(key, map1, map2);
+  return true;
+}
+
+MapCacheStatistics MapCache::Statistics() const {
+  lock_guard<mutex> lock(mutex_);
+  return statistics_;
+}
+
+void MapCache::Clear() {
+  lock_guard<mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+}
+
+void MapCache::Touch(EntryList::iterator it) {
+  entries_.splice(entries_.begin(), entries_, it);
+}
+
+void MapCache::Remember(const string& key, const Entry& entry) {
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->second = entry;
+    Touch(it->second);
+    return;
+  }
+  if (capacity_ == 0) {
+    return;
+  }
+  entries_.emplace_front(key, entry);
+  index_[key] = entries_.begin();
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    statistics_.evictions++;
+  }
+}
+
+string MapCache::Filename(const string& key) const {
+  ostringstream name;
+  name << hex << setw(16) << setfill('0') << Fnv1a(key) << ".map";
+  return (boost::filesystem::path(directory_) / name.str()).string();
+}
+
+bool MapCache::Load(const string& key, Entry& entry) const {
+  string filename = Filename(key);
+  if (!boost::filesystem::exists(filename)) {
+    return false;
+  }
+
+  // The maps are copied out of the mapping, so the cached entry (and the
+  // maps returned to callers) never refer to the file once it is unmapped
+  boost::iostreams::mapped_file_source file;
+  try {
+    file.open(filename);
+  } catch (const exception&) {
+    cerr << "Map cache entry could not be mapped: " << filename << endl;
+    return false;
+  }
+
+  if (file.size() < sizeof(FileHeader)) {
+    return false;
+  }
+  FileHeader header;
+  memcpy(&header, file.data(), sizeof(FileHeader));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.key_length != key.size()) {
+    return false;
+  }
+
+  // Guard against hash collisions and truncated files
+  size_t offset = DataOffset(header.key_length);
+  size_t plane_bytes =
+      static_cast<size_t>(header.rows) * header.cols * sizeof(float);
+  if (file.size() < offset + 2 * plane_bytes ||
+      key.compare(0, string::npos, file.data() + sizeof(FileHeader),
+                  header.key_length) != 0) {
+    return false;
+  }
+
+  char* data = const_cast<char*>(file.data()) + offset;
+  entry.map1 = cv::Mat(header.rows, header.cols, CV_32FC1, data).clone();
+  entry.map2 =
+      cv::Mat(header.rows, header.cols, CV_32FC1, data + plane_bytes).clone();
+  return true;
+}
+
+bool MapCache::Store(const string& key, const Entry& entry) const {
+  FileHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.rows = entry.map1.rows;
+  header.cols = entry.map1.cols;
+  header.key_length = key.size();
+  header.reserved = 0;
+
+  // Write to a temporary file and rename it into place so that concurrent
+  // readers never observe a partially written entry
+  boost::filesystem::path filename = Filename(key);
+  boost::filesystem::path temporary = boost::filesystem::unique_path(
+      filename.string() + ".%%%%-%%%%-%%%%.tmp");
+  ofstream f(temporary.string(), ios::binary);
+  if (!f.is_open()) {
+    return false;
+  }
+  f.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+  f.write(key.data(), key.size());
+  const char padding[16] = {0};
+  f.write(padding, DataOffset(key.size()) - sizeof(FileHeader) - key.size());
+  for (const cv::Mat* map : {&entry.map1, &entry.map2}) {
+    for (int r = 0; r < map->rows; r++) {
+      f.write(reinterpret_cast<const char*>(map->ptr<float>(r)),
+              map->cols * sizeof(float));
+    }
+  }
+  f.close();
+  boost::system::error_code error;
+  if (!f) {
+    boost::filesystem::remove(temporary, error);
+    return false;
+  }
+
+  boost::filesystem::rename(temporary, filename, error);
+  if (error) {
+    boost::filesystem::remove(temporary, error);
+    return false;
+  }
+  return true;
+}
+}
@@ -0,0 +1,138 @@
+/** Interface file for memoizing remapping coordinate maps
+ *
+ *  \file ipcv/geometric_transformation/MapCache.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    Batch jobs tend to apply a handful of fixed transformations to a
+ *    large number of images, so the (map1, map2) pairs produced by
+ *    MapRST, MapQ2Q, MapGCP, ... may be reused rather than recomputed.
+ *
+ *    Maps are keyed by a string describing the transformation, its
+ *    parameters and the size of the source and destination images (see
+ *    MapCacheKey).  Recently used maps are held in memory (least recently
+ *    used entries are evicted once the capacity is reached).  If a cache
+ *    directory is provided, every map is also written to disk and later
+ *    lookups (possibly from a different process) read the stored file
+ *    (memory-mapped) instead of recomputing the maps.
+ *
+ *    Callers always receive their own copy of the maps, so the cached
+ *    entries can neither be modified through nor be released (evicted,
+ *    cleared, unmapped) out from under the maps handed out.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/// Reuse statistics gathered by a MapCache
+struct MapCacheStatistics {
+  size_t memory_hits = 0;  ///< Lookups satisfied from memory
+  size_t disk_hits = 0;    ///< Lookups satisfied from the cache directory
+  size_t misses = 0;       ///< Lookups that required computing the maps
+  size_t evictions = 0;    ///< Entries dropped from memory (LRU)
+
+  /// Fraction of lookups that did not require computing the maps
+  double HitRate() const;
+};
+
+/** Build a cache key for a transformation
+ *
+ *  \param[in] transform   name of the transformation (e.g. "rst")
+ *  \param[in] parameters  parameters that fully define the transformation
+ *  \param[in] src_size    size of the source image
+ *  \param[in] dst_size    size of the destination map
+ *
+ *  \return                key string (parameters are printed with full
+ *                         precision so distinct doubles never collide)
+ */
+std::string MapCacheKey(const std::string& transform,
+                        const std::vector<double>& parameters,
+                        const cv::Size& src_size, const cv::Size& dst_size);
+
+class MapCache {
+ public:
+  /** Create a map cache
+   *
+   *  \param[in] capacity   maximum number of map pairs held in memory
+   *  \param[in] directory  directory in which maps are stored on disk
+   *                        [default is empty, maps are only held in memory]
+   */
+  explicit MapCache(const size_t capacity = 8,
+                    const std::string& directory = "");
+
+  /** Look up the maps stored under the provided key
+   *
+   *  \param[in] key    key as returned by MapCacheKey
+   *  \param[out] map1  cv::Mat of CV_32FC1 horizontal (x) coordinates (a
+   *                    copy owned by the caller)
+   *  \param[out] map2  cv::Mat of CV_32FC1 vertical (y) coordinates (a
+   *                    copy owned by the caller)
+   *
+   *  \return           a boolean indicating that the maps were found
+   */
+  bool Lookup(const std::string& key, cv::Mat& map1, cv::Mat& map2);
+
+  /** Store maps under the provided key (in memory and, if a cache
+   *  directory was provided, on disk)
+   *
+   *  \param[in] key    key as returned by MapCacheKey
+   *  \param[in] map1   cv::Mat of CV_32FC1 horizontal (x) coordinates
+   *  \param[in] map2   cv::Mat of CV_32FC1 vertical (y) coordinates
+   */
+  void Insert(const std::string& key, const cv::Mat& map1,
+              const cv::Mat& map2);
+
+  /** Look up the maps stored under the provided key, computing and
+   *  storing them if they are not present
+   *
+   *  \param[in] key      key as returned by MapCacheKey
+   *  \param[in] compute  function producing (map1, map2), returning false
+   *                      on error
+   *  \param[out] map1    cv::Mat of CV_32FC1 horizontal (x) coordinates
+   *  \param[out] map2    cv::Mat of CV_32FC1 vertical (y) coordinates
+   *
+   *  \return             a boolean indicating that the maps are available
+   */
+  bool Get(const std::string& key,
+           const std::function<bool(cv::Mat&, cv::Mat&)>& compute,
+           cv::Mat& map1, cv::Mat& map2);
+
+  /// Reuse statistics gathered since construction
+  MapCacheStatistics Statistics() const;
+
+  /// Drop all in-memory entries (files in the cache directory are kept)
+  void Clear();
+
+ private:
+  struct Entry {
+    cv::Mat map1;
+    cv::Mat map2;
+  };
+  typedef std::list<std::pair<std::string, Entry>> EntryList;
+
+  void Touch(EntryList::iterator it);
+  void Remember(const std::string& key, const Entry& entry);
+  std::string Filename(const std::string& key) const;
+  bool Load(const std::string& key, Entry& entry) const;
+  bool Store(const std::string& key, const Entry& entry) const;
+
+  size_t capacity_;
+  std::string directory_;
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+  MapCacheStatistics statistics_;
+  mutable std::mutex mutex_;
+};
+}
@@ -0,0 +1,72 @@
+/** Implementation file for locally adaptive linear histogram enhancement
+ *
+ *  \file ipcv/histogram_enhancement/AdaptiveLinearEnhancement.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "AdaptiveLinearEnhancement.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "imgs/ipcv/utils/SlidingHistogram.h"
+
+using namespace std;
+
+namespace ipcv {
+
+bool AdaptiveLinearEnhancement(const cv::Mat& src, const int radius,
+                               const int percentage, cv::Mat& dst) {
+    if (src.type() != CV_8UC1 && src.type() != CV_8UC3) {
+        cerr << "Adaptive linear enhancement requires a CV_8UC1 or CV_8UC3 "
+             << "source image" << endl;
+        return false;
+    }
+    if (percentage < 0 || percentage >= 50) {
+        cerr << "Adaptive linear enhancement percentage must be in [0, 50)"
+             << endl;
+        return false;
+    }
+
+    // Ranks of the lower and upper extremes within a window, the lower
+    // extreme is the first grey level whose CDF reaches the lower cutoff
+    // (as in LinearLut)
+    const int count = (2 * radius + 1) * (2 * radius + 1);
+    const int lower_rank = max(
+        static_cast<int>(ceil(percentage * 0.01 * count)) - 1, 0);
+    const int upper_rank = max(
+        static_cast<int>(ceil((1 - percentage * 0.01) * count)) - 1, 0);
+
+    vector<cv::Mat> channels;
+    cv::split(src, channels);
+    for (auto& channel : channels) {
+        cv::Mat enhanced(channel.size(), CV_8UC1);
+        bool status = SlidingHistogram(
+            channel, radius,
+            [&](const int r, const int c, const uint16_t* histogram,
+                const uint16_t* coarse) {
+                int low = HistogramRank(histogram, coarse, lower_rank);
+                int up = HistogramRank(histogram, coarse, upper_rank);
+                int value = channel.ptr<uint8_t>(r)[c];
+                uint8_t& out = enhanced.ptr<uint8_t>(r)[c];
+                if (value <= low) {
+                    out = 0;
+                } else if (value >= up) {
+                    out = 255;
+                } else {
+                    out = static_cast<uint8_t>(
+                        255 * (value - low) / (up - low));
+                }
+            });
+        if (!status) {
+            return false;
+        }
+        channel = enhanced;
+    }
+    cv::merge(channels, dst);
+    return true;
+}
+}
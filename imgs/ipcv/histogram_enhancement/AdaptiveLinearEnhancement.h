@@ -0,0 +1,34 @@
+/** Interface file for locally adaptive linear histogram enhancement
+ *
+ *  \file ipcv/histogram_enhancement/AdaptiveLinearEnhancement.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/** Enhance an image by linearly stretching every pixel between the tails
+ *  of the histogram of its surrounding window (the locally adaptive
+ *  counterpart of LinearLut)
+ *
+ *  The window histograms are maintained with SlidingHistogram, so the
+ *  cost per pixel does not depend on the window radius.
+ *
+ *  \param[in] src          source cv::Mat of CV_8UC1 or CV_8UC3
+ *  \param[in] radius       window radius, the window is (2 * radius + 1)
+ *                          pixels square [0, 127]
+ *  \param[in] percentage   the percentage to remove from each tail of the
+ *                          window histogram to find the extremes of the
+ *                          linear enhancement function
+ *  \param[out] dst         destination cv::Mat of the same type as src
+ *
+ *  \return                 a boolean indicating that the enhancement has
+ *                          been carried out without error
+ */
+bool AdaptiveLinearEnhancement(const cv::Mat& src, const int radius,
+                               const int percentage, cv::Mat& dst);
+}
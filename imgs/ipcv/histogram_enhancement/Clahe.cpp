@@ -0,0 +1,183 @@
+/** Implementation file for contrast-limited adaptive histogram equalization
+ *
+ *  \file ipcv/histogram_enhancement/Clahe.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "Clahe.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+// Clip a tile histogram at limit, redistribute the excess evenly over all
+// of the bins, and convert the result into an equalization LUT
+void ClippedLut(int* h, const int limit, const int area, uint8_t* lut) {
+    int excess = 0;
+    for (int dc = 0; dc < 256; dc++) {
+        if (h[dc] > limit) {
+            excess += h[dc] - limit;
+            h[dc] = limit;
+        }
+    }
+    int increment = excess / 256;
+    int residual = excess - increment * 256;
+    for (int dc = 0; dc < 256; dc++) {
+        h[dc] += increment;
+    }
+    // Spread the remainder evenly across the range rather than piling it
+    // into the lowest bins
+    if (residual > 0) {
+        int step = max(256 / residual, 1);
+        for (int dc = 0; dc < 256 && residual > 0; dc += step, residual--) {
+            h[dc]++;
+        }
+    }
+
+    const float scale = 255.f / area;
+    int sum = 0;
+    for (int dc = 0; dc < 256; dc++) {
+        sum += h[dc];
+        lut[dc] = static_cast<uint8_t>(min(cvRound(sum * scale), 255));
+    }
+}
+
+// Interpolation between tile centres along one axis: for every pixel the
+// index of the nearer-or-preceding tile, the following tile, and the
+// weight of the following tile
+struct Blend {
+    int first;
+    int second;
+    float weight;
+};
+
+vector<Blend> Blends(const int length, const int tiles) {
+    vector<Blend> blends(length);
+    const float tile_length = static_cast<float>(length) / tiles;
+    for (int i = 0; i < length; i++) {
+        float t = (i + 0.5f) / tile_length - 0.5f;
+        int first = static_cast<int>(floor(t));
+        float weight = t - first;
+        int second = first + 1;
+        if (first < 0) {
+            first = second = 0;
+            weight = 0;
+        } else if (second > tiles - 1) {
+            first = second = tiles - 1;
+            weight = 0;
+        }
+        blends[i] = {first, second, weight};
+    }
+    return blends;
+}
+
+// Map a row through the horizontal blend of the (vertically blended) LUTs
+// of its tiles
+template <int channels>
+void BlendRow(const float* lut, const vector<Blend>& blend_x,
+              const uint8_t* p, uint8_t* q) {
+    const int cols = static_cast<int>(blend_x.size());
+    for (int c = 0; c < cols; c++) {
+        const Blend& bx = blend_x[c];
+        const float* left = lut + bx.first * channels * 256;
+        const float* right = lut + bx.second * channels * 256;
+        for (int b = 0; b < channels; b++) {
+            int i = c * channels + b;
+            int v = b * 256 + p[i];
+            q[i] = static_cast<uint8_t>(left[v] +
+                                        bx.weight * (right[v] - left[v]));
+        }
+    }
+}
+}
+
+bool Clahe(const cv::Mat& src, cv::Mat& dst, const double clip_limit,
+           const cv::Size& tiles) {
+    if (src.type() != CV_8UC1 && src.type() != CV_8UC3) {
+        cerr << "CLAHE requires a CV_8UC1 or CV_8UC3 source image" << endl;
+        return false;
+    }
+    if (tiles.width < 1 || tiles.height < 1 || tiles.width > src.cols ||
+        tiles.height > src.rows) {
+        cerr << "CLAHE requires between 1 tile and 1 tile per pixel along "
+             << "each axis" << endl;
+        return false;
+    }
+
+    const int channels = src.channels();
+    const int tiles_x = tiles.width;
+    const int tiles_y = tiles.height;
+
+    // Clipped LUT for every tile and channel, tiles in parallel
+    vector<uint8_t> luts(tiles_x * tiles_y * channels * 256);
+    cv::parallel_for_(cv::Range(0, tiles_x * tiles_y),
+                      [&](const cv::Range& range) {
+        vector<int> h(channels * 256);
+        for (int t = range.start; t < range.end; t++) {
+            int tx = t % tiles_x;
+            int ty = t / tiles_x;
+            int c0 = tx * src.cols / tiles_x;
+            int c1 = (tx + 1) * src.cols / tiles_x;
+            int r0 = ty * src.rows / tiles_y;
+            int r1 = (ty + 1) * src.rows / tiles_y;
+
+            fill(h.begin(), h.end(), 0);
+            for (int r = r0; r < r1; r++) {
+                const uint8_t* p = src.ptr<uint8_t>(r);
+                for (int i = c0 * channels; i < c1 * channels;
+                     i += channels) {
+                    for (int b = 0; b < channels; b++) {
+                        h[b * 256 + p[i + b]]++;
+                    }
+                }
+            }
+
+            int area = (r1 - r0) * (c1 - c0);
+            int limit = max(static_cast<int>(clip_limit * area / 256), 1);
+            for (int b = 0; b < channels; b++) {
+                ClippedLut(&h[b * 256], limit, area,
+                           &luts[(t * channels + b) * 256]);
+            }
+        }
+    });
+
+    // Blend the LUTs of the four surrounding tiles for every pixel.  The
+    // vertical blend only depends on the row, so it is applied once per row
+    // to the LUTs of the two surrounding tile rows, leaving one horizontal
+    // blend per pixel.
+    const vector<Blend> blend_x = Blends(src.cols, tiles_x);
+    const vector<Blend> blend_y = Blends(src.rows, tiles_y);
+    const int row_size = tiles_x * channels * 256;
+    dst.create(src.size(), src.type());
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        vector<float> row_luts(row_size);
+        for (int r = range.start; r < range.end; r++) {
+            const Blend& by = blend_y[r];
+            const uint8_t* top = &luts[by.first * row_size];
+            const uint8_t* bottom = &luts[by.second * row_size];
+            for (int i = 0; i < row_size; i++) {
+                row_luts[i] =
+                    top[i] + by.weight * (bottom[i] - top[i]) + 0.5f;
+            }
+
+            if (channels == 1) {
+                BlendRow<1>(row_luts.data(), blend_x, src.ptr<uint8_t>(r),
+                            dst.ptr<uint8_t>(r));
+            } else {
+                BlendRow<3>(row_luts.data(), blend_x, src.ptr<uint8_t>(r),
+                            dst.ptr<uint8_t>(r));
+            }
+        }
+    });
+
+    return true;
+}
+}
@@ -0,0 +1,39 @@
+/** Interface file for contrast-limited adaptive histogram equalization
+ *
+ *  \file ipcv/histogram_enhancement/Clahe.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/** Enhance an image using contrast-limited adaptive histogram equalization
+ *
+ *  The image is divided into a grid of tiles and a clipped equalization
+ *  LUT is computed for every tile (tiles are processed in parallel).  The
+ *  counts of each tile histogram above the clip limit are redistributed
+ *  evenly over all of the grey levels.  Every output pixel is then mapped
+ *  through the LUTs of the four nearest tiles, blended bilinearly
+ *  according to its distance from the tile centres, in a single pass over
+ *  the image (rows are processed in parallel).
+ *
+ *  \param[in] src         source cv::Mat of CV_8UC1 or CV_8UC3 (channels are
+ *                         equalized independently)
+ *  \param[out] dst        destination cv::Mat of the same type as src
+ *  \param[in] clip_limit  maximum count of a histogram bin relative to the
+ *                         count of a uniform histogram of the tile (1
+ *                         leaves the tiles unchanged, larger values give
+ *                         more contrast) [default is 2]
+ *  \param[in] tiles       number of tiles across and down the image
+ *                         [default is 8 x 8]
+ *
+ *  \return                a boolean indicating that the enhancement has
+ *                         been carried out without error
+ */
+bool Clahe(const cv::Mat& src, cv::Mat& dst, const double clip_limit = 2.0,
+           const cv::Size& tiles = cv::Size(8, 8));
+}
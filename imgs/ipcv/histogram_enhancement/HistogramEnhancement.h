@@ -7,5 +7,7 @@
 
 #pragma once
 
+#include "imgs/ipcv/histogram_enhancement/AdaptiveLinearEnhancement.h"
+#include "imgs/ipcv/histogram_enhancement/Clahe.h"
 #include "imgs/ipcv/histogram_enhancement/LinearLut.h"
 #include "imgs/ipcv/histogram_enhancement/MatchingLut.h"
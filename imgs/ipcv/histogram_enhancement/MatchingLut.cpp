@@ -15,46 +15,98 @@ using namespace std;
 
 namespace ipcv {
 
-/** Create a 3-channel (color) LUT using histogram matching
+namespace {
+
+// Build one channel of the matching LUT.  Both CDFs are non-decreasing, so
+// the target level closest to the source CDF never moves backwards as the
+// source level increases and a single forward sweep over the target
+// histogram finds every match (the CDFs are accumulated on the fly in the
+// same order as HistogramToCdf).
+template <typename T>
+void MatchChannel(const int* src_h, const double src_total, const int* tgt_h,
+                  const double tgt_total, const int bins, T* lut) {
+    double src_cdf = 0;
+    // Target CDF at level j and the first level sharing that CDF value,
+    // along with the value and first level of the preceding run of levels
+    int j = 0;
+    double tgt_cdf = tgt_h[0] / tgt_total;
+    int run_start = 0;
+    bool has_previous = false;
+    double previous_cdf = 0;
+    int previous_start = 0;
+
+    for (int dc = 0; dc < bins; dc++) {
+        src_cdf += src_h[dc] / src_total;
+
+        // Advance to the first target level whose CDF reaches the source
+        // CDF
+        while (j < bins - 1 && tgt_cdf < src_cdf) {
+            j++;
+            double next_cdf = tgt_cdf + tgt_h[j] / tgt_total;
+            if (next_cdf != tgt_cdf) {
+                has_previous = true;
+                previous_cdf = tgt_cdf;
+                previous_start = run_start;
+                run_start = j;
+            }
+            tgt_cdf = next_cdf;
+        }
+
+        // The closest CDF value is either that of level j or that of the
+        // run just below it, ties go to the lower level
+        int match = run_start;
+        if (tgt_cdf >= src_cdf && has_previous &&
+            src_cdf - previous_cdf <= tgt_cdf - src_cdf) {
+            match = previous_start;
+        }
+        lut[dc] = static_cast<T>(match);
+    }
+}
+}
+
+/** Create a (color) LUT using histogram matching
  *
- *  \param[in] src   source cv::Mat of CV_8UC3
- *  \param[in] h     the histogram in cv:Mat(3, 256) that the
- *                   source is to be matched to
- *  \param[out] lut  3-channel look up table in cv::Mat(3, 256)
+ *  \param[in] src   source cv::Mat of CV_8UC1, CV_8UC3, CV_16UC1 or CV_16UC3
+ *  \param[in] h     the histogram in cv:Mat(channels, 256) (8-bit) or
+ *                   cv::Mat(channels, 65536) (16-bit) that the source is
+ *                   to be matched to
+ *  \param[out] lut  look up table in cv::Mat(channels, 256) of CV_8UC1 or
+ *                   cv::Mat(channels, 65536) of CV_16UC1
  */
 bool MatchingLut(const cv::Mat& src, const cv::Mat& h, cv::Mat& lut) {
-  
+    if (src.depth() != CV_8U && src.depth() != CV_16U) {
+        cerr << "Histogram matching requires an 8-bit or 16-bit source image"
+             << endl;
+        return false;
+    }
+
     // Create a histogram of the source image
     cv::Mat_<int> src_h;
     ipcv::Histogram(src, src_h);
-    // Generate the cumulative density function of the source image
-    cv::Mat_<double> src_cdf;
-    ipcv::HistogramToCdf(src_h, src_cdf);
-    // Generate the cumulative density function of the target image
-    cv::Mat_<double> tgt_cdf;
-    ipcv::HistogramToCdf(h, tgt_cdf);
-    // Separate the target cdf rows by color
-    cv::Mat blue = tgt_cdf.row(0);
-    cv::Mat green = tgt_cdf.row(1);
-    cv::Mat red = tgt_cdf.row(2);
-    double minVal;
-    double maxVal;
-    cv::Point minIdx;
-    cv::Point maxIdx;
-    double value;
-    lut.create(3, 256, CV_8UC1);
-    for(int dc = 0; dc < lut.cols; dc++){
-        // Find the best mapping between the CDFs by finding the index with the minimum difference in
-        // values for each channels
-        value = src_cdf.at<double>(0, dc);
-        cv::minMaxLoc(abs(blue-value), &minVal, &maxVal, &minIdx, &maxIdx);
-        lut.at<uchar>(0, dc) = minIdx.x;
-        value = src_cdf.at<double>(1, dc);
-        cv::minMaxLoc(abs(green-value), &minVal, &maxVal, &minIdx, &maxIdx);
-        lut.at<uchar>(1, dc) = minIdx.x;
-        value = src_cdf.at<double>(2, dc);
-        cv::minMaxLoc(abs(red-value), &minVal, &maxVal, &minIdx, &maxIdx);
-        lut.at<uchar>(2, dc) = minIdx.x;
+    if (h.type() != CV_32SC1 || h.size() != src_h.size()) {
+        cerr << "The target histogram must have one CV_32S row per source "
+             << "channel and one bin per source grey level" << endl;
+        return false;
+    }
+
+    const int channels = src_h.rows;
+    const int bins = src_h.cols;
+    const double src_total = cv::sum(src_h.row(0))[0];
+    const double tgt_total = cv::sum(h.row(0))[0];
+    if (src_total <= 0 || tgt_total <= 0) {
+        cerr << "Histogram matching requires non-empty histograms" << endl;
+        return false;
+    }
+
+    lut.create(channels, bins, bins == 256 ? CV_8UC1 : CV_16UC1);
+    for (int b = 0; b < channels; b++) {
+        if (bins == 256) {
+            MatchChannel(src_h.ptr<int>(b), src_total, h.ptr<int>(b),
+                         tgt_total, bins, lut.ptr<uint8_t>(b));
+        } else {
+            MatchChannel(src_h.ptr<int>(b), src_total, h.ptr<int>(b),
+                         tgt_total, bins, lut.ptr<uint16_t>(b));
+        }
     }
 
   return true;
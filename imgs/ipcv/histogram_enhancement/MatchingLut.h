@@ -11,12 +11,14 @@
 
 namespace ipcv {
 
-/** Create a 3-channel (color) LUT using histogram matching
+/** Create a (color) LUT using histogram matching
  *
- *  \param[in] src   source cv::Mat of CV_8UC3
- *  \param[in] h     the histogram in cv:Mat(3, 256) that the
- *                   source is to be matched to
- *  \param[out] lut  3-channel look up table in cv::Mat(3, 256)
+ *  \param[in] src   source cv::Mat of CV_8UC1, CV_8UC3, CV_16UC1 or CV_16UC3
+ *  \param[in] h     the histogram in cv:Mat(channels, 256) (8-bit) or
+ *                   cv::Mat(channels, 65536) (16-bit) that the source is
+ *                   to be matched to
+ *  \param[out] lut  look up table in cv::Mat(channels, 256) of CV_8UC1 or
+ *                   cv::Mat(channels, 65536) of CV_16UC1
  */
 bool MatchingLut(const cv::Mat& src, const cv::Mat& h, cv::Mat& lut);
 }
@@ -0,0 +1,85 @@
+/** Implementation file for finding locally adaptive Otsu's thresholds
+ *
+ *  \file ipcv/otsus_threshold/AdaptiveOtsusThreshold.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "AdaptiveOtsusThreshold.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "imgs/ipcv/utils/SlidingHistogram.h"
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+// Otsu's threshold of a window histogram holding count pixels, the search
+// is limited to the occupied range of grey levels
+int WindowThreshold(const uint16_t* histogram, const uint16_t* coarse,
+                    const int count) {
+    const int lowest = HistogramRank(histogram, coarse, 0);
+    const int highest = HistogramRank(histogram, coarse, count - 1);
+    int64_t total = 0;
+    for (int dc = lowest; dc <= highest; dc++) {
+        total += static_cast<int64_t>(dc) * histogram[dc];
+    }
+
+    // Maximize the (scaled) between class variance
+    //   (total * w - count * sum)^2 / (w * (count - w))
+    int threshold = lowest;
+    double best = -1;
+    int64_t w = 0;
+    int64_t sum = 0;
+    for (int dc = lowest; dc < highest; dc++) {
+        w += histogram[dc];
+        sum += static_cast<int64_t>(dc) * histogram[dc];
+        if (w == 0) {
+            continue;
+        }
+        double difference = static_cast<double>(total * w - count * sum);
+        double variance =
+            difference * difference / (static_cast<double>(w) * (count - w));
+        if (variance > best) {
+            best = variance;
+            threshold = dc;
+        }
+    }
+    return threshold;
+}
+}
+
+bool AdaptiveOtsusThreshold(const cv::Mat& src, const int radius,
+                            cv::Mat& threshold) {
+    if (src.type() != CV_8UC1 && src.type() != CV_8UC3) {
+        cerr << "Adaptive Otsu's threshold requires a CV_8UC1 or CV_8UC3 "
+             << "source image" << endl;
+        return false;
+    }
+
+    const int count = (2 * radius + 1) * (2 * radius + 1);
+    vector<cv::Mat> channels;
+    cv::split(src, channels);
+    for (auto& channel : channels) {
+        cv::Mat thresholds(channel.size(), CV_8UC1);
+        bool status = SlidingHistogram(
+            channel, radius,
+            [&](const int r, const int c, const uint16_t* histogram,
+                const uint16_t* coarse) {
+                thresholds.ptr<uint8_t>(r)[c] =
+                    WindowThreshold(histogram, coarse, count);
+            });
+        if (!status) {
+            return false;
+        }
+        channel = thresholds;
+    }
+    cv::merge(channels, threshold);
+    return true;
+}
+}
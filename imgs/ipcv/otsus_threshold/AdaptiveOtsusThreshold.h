@@ -0,0 +1,33 @@
+/** Interface file for finding locally adaptive Otsu's thresholds
+ *
+ *  \file ipcv/otsus_threshold/AdaptiveOtsusThreshold.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/** Find Otsu's threshold of the window surrounding every pixel of an image
+ *  (the locally adaptive counterpart of OtsusThreshold)
+ *
+ *  The window histograms are maintained with SlidingHistogram, so the
+ *  cost per pixel does not depend on the window radius.
+ *
+ *  \param[in] src          source cv::Mat of CV_8UC1 or CV_8UC3
+ *  \param[in] radius       window radius, the window is (2 * radius + 1)
+ *                          pixels square [0, 127]
+ *  \param[out] threshold   per-pixel, per-channel thresholds in a cv::Mat
+ *                          of the same type as src (pixels with values
+ *                          less than or equal to their threshold belong to
+ *                          the lower class)
+ *
+ *  \return                 a boolean indicating that the thresholds were
+ *                          found without error
+ */
+bool AdaptiveOtsusThreshold(const cv::Mat& src, const int radius,
+                            cv::Mat& threshold);
+}
@@ -8,6 +8,7 @@
 #include "OtsusThreshold.h"
 
 #include <iostream>
+#include <vector>
 
 #include "imgs/ipcv/utils/Utils.h"
 
@@ -15,6 +16,91 @@ using namespace std;
 
 namespace ipcv {
 
+namespace {
+
+// Otsu's threshold of a single channel histogram in one sweep: with w and
+// s the count and grey level sum of the lower class, the between-class
+// variance is proportional to (total_sum * w - total * s)^2 / (w (total - w))
+int ChannelThreshold(const int* h) {
+    double total = 0;
+    double total_sum = 0;
+    for (int dc = 0; dc < 256; dc++) {
+        total += h[dc];
+        total_sum += static_cast<double>(dc) * h[dc];
+    }
+
+    int threshold = 0;
+    double best = -1;
+    double w = 0;
+    double s = 0;
+    for (int dc = 0; dc < 255; dc++) {
+        w += h[dc];
+        s += static_cast<double>(dc) * h[dc];
+        if (w == 0 || w == total) {
+            continue;
+        }
+        double difference = total_sum * w - total * s;
+        double variance = difference * difference / (w * (total - w));
+        if (variance > best) {
+            best = variance;
+            threshold = dc;
+        }
+    }
+    return threshold;
+}
+
+// Multi-level Otsu's thresholds of a single channel histogram.  Maximizing
+// the between-class variance is equivalent to maximizing the sum over the
+// classes [a, b] of S(a, b)^2 / P(a, b), with P and S the count and grey
+// level sum of the class, which is solved by dynamic programming:
+//   best[k][t] = max_s best[k - 1][s] + S(s + 1, t)^2 / P(s + 1, t)
+void ChannelThresholds(const int* h, const int count, int* thresholds) {
+    // Prefix sums, index i covers grey levels [0, i)
+    vector<double> p(257, 0);
+    vector<double> s(257, 0);
+    for (int dc = 0; dc < 256; dc++) {
+        p[dc + 1] = p[dc] + h[dc];
+        s[dc + 1] = s[dc] + static_cast<double>(dc) * h[dc];
+    }
+    auto term = [&](const int a, const int b) {
+        double n = p[b + 1] - p[a];
+        if (n <= 0) {
+            return 0.0;
+        }
+        double sum = s[b + 1] - s[a];
+        return sum * sum / n;
+    };
+
+    // best[k][t]: classes 0..k covering grey levels [0, t], with class k
+    // ending at t; from[k][t]: end of class k - 1 for that optimum
+    const int classes = count + 1;
+    vector<vector<double>> best(classes, vector<double>(256, -1));
+    vector<vector<int>> from(classes, vector<int>(256, -1));
+    for (int t = 0; t < 256; t++) {
+        best[0][t] = term(0, t);
+    }
+    for (int k = 1; k < classes; k++) {
+        // Class k - 1 ends at s >= k - 1 and class k at t > s, leaving room
+        // for the remaining classes
+        for (int t = k; t < 256 - (classes - 1 - k); t++) {
+            for (int e = k - 1; e < t; e++) {
+                double value = best[k - 1][e] + term(e + 1, t);
+                if (value > best[k][t]) {
+                    best[k][t] = value;
+                    from[k][t] = e;
+                }
+            }
+        }
+    }
+
+    int t = 255;
+    for (int k = count; k >= 1; k--) {
+        t = from[k][t];
+        thresholds[k - 1] = t;
+    }
+}
+}
+
 /** Find Otsu's threshold for each channel of a 3-channel (color) image
  *
  *  \param[in] src          source cv::Mat of CV_8UC3
@@ -23,70 +109,43 @@ namespace ipcv {
  */
 bool OtsusThreshold(const cv::Mat& src, cv::Vec3b& threshold) {
     threshold = cv::Vec3b();
-    // Create the histogram, pdf, and cdf, of the source image
+    if (src.type() != CV_8UC3 || src.empty()) {
+        cerr << "Otsu's threshold requires a non-empty CV_8UC3 source image"
+             << endl;
+        return false;
+    }
+
     cv::Mat_<int> h;
     ipcv::Histogram(src, h);
-    cv::Mat_<double> pdf;
-    ipcv::HistogramToPdf(h, pdf);
-    cv::Mat_<double> cdf;
-    ipcv::HistogramToCdf(h, cdf);
-    // Create a 256x3 matrix of linearly incrementing DC values
-    cv::Mat linearDC;
-    linearDC = cv::Mat::zeros(3, 256, CV_64FC1);
-    for(int i = 0; i < 256; i++){
-        linearDC.at<double>(0,i) = i;
-        linearDC.at<double>(1,i) = i;
-        linearDC.at<double>(2,i) = i;
+    for (int b = 0; b < 3; b++) {
+        threshold[b] = ChannelThreshold(h.ptr<int>(b));
     }
 
-    // Create 256x3 matrices for the mean values and the cumulative mean values
-    cv::Mat mu;
-    mu.create(cdf.size(), cdf.type());
-    cv::Mat muTotal;
-    muTotal.create(cdf.size(), cdf.type());
-    // Find the means
-    cv::multiply(linearDC, pdf, mu);
-    // Set the first value of the total mean values to the start of the mean values
-    muTotal.at<double>(0,0) = mu.at<double>(0,0);
-    muTotal.at<double>(1,0) = mu.at<double>(1,0);
-    muTotal.at<double>(2,0) = mu.at<double>(2,0);
-    // Create the cumulative mean values
-    for(int i = 1; i < 256; i++){
-        muTotal.at<double>(0,i) = muTotal.at<double>(0,i-1) + mu.at<double>(0,i);
-        muTotal.at<double>(1,i) = muTotal.at<double>(1,i-1) + mu.at<double>(1,i);
-        muTotal.at<double>(2,i) = muTotal.at<double>(2,i-1) + mu.at<double>(2,i);
-    }
-    // Grab the last values of the cumulative means and arrange them in a vector
-    cv::Vec3d mean(3);
-    mean = {muTotal.at<double>(0,255), muTotal.at<double>(1,255), muTotal.at<double>(2,255)};
-    
-    // Perform the variance calculations for each image channel
-    cv::Mat numer, denom;
-    cv::Mat bcVar;
-    bcVar.create(cdf.size(), cdf.type());
-    cv::pow(mean[0]*cdf.row(0)-muTotal.row(0), 2, numer);
-    cv::pow(cdf.row(0), 2, denom);
-    denom = cdf.row(0)-denom;
-    cv::divide(numer, denom, bcVar.row(0));
-    cv::pow(mean[1]*cdf.row(1)-muTotal.row(1), 2, numer);
-    cv::pow(cdf.row(1), 2, denom);
-    denom = cdf.row(1)-denom;
-    cv::divide(numer, denom, bcVar.row(1));
-    cv::pow(mean[2]*cdf.row(2)-muTotal.row(2), 2, numer);
-    cv::pow(cdf.row(2), 2, denom);
-    denom = cdf.row(2)-denom;
-    cv::divide(numer, denom, bcVar.row(2));
-    
-    // Find the max variances for each channel and set their index(digital count) to be the threshold
-    double minVal, maxVal;
-    cv::Point minIdx, maxIdx;
-    cv::minMaxLoc(bcVar.row(0), &minVal, &maxVal, &minIdx, &maxIdx);
-    threshold[0] = maxIdx.x;
-    cv::minMaxLoc(bcVar.row(1), &minVal, &maxVal, &minIdx, &maxIdx);
-    threshold[1] = maxIdx.x;
-    cv::minMaxLoc(bcVar.row(2), &minVal, &maxVal, &minIdx, &maxIdx);
-    threshold[2] = maxIdx.x;
-    
   return true;
 }
+
+bool MultilevelOtsusThreshold(const cv::Mat& src, const int count,
+                              cv::Mat& thresholds) {
+    if ((src.type() != CV_8UC1 && src.type() != CV_8UC3) || src.empty()) {
+        cerr << "Otsu's thresholds require a non-empty CV_8UC1 or CV_8UC3 "
+             << "source image" << endl;
+        return false;
+    }
+    if (count < 1 || count > 4) {
+        cerr << "The number of Otsu's thresholds must be in [1, 4]" << endl;
+        return false;
+    }
+
+    cv::Mat_<int> h;
+    ipcv::Histogram(src, h);
+    thresholds.create(h.rows, count, CV_32SC1);
+    for (int b = 0; b < h.rows; b++) {
+        if (count == 1) {
+            thresholds.at<int>(b, 0) = ChannelThreshold(h.ptr<int>(b));
+        } else {
+            ChannelThresholds(h.ptr<int>(b), count, thresholds.ptr<int>(b));
+        }
+    }
+    return true;
+}
 }
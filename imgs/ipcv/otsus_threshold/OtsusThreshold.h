@@ -18,4 +18,21 @@ namespace ipcv {
  *                          color image in cv::Vec3b
  */
 bool OtsusThreshold(const cv::Mat& src, cv::Vec3b& threshold);
+
+/** Find multi-level Otsu's thresholds for each channel of an image
+ *
+ *  The thresholds maximize the between-class variance of the resulting
+ *  classes.  Since the objective is a sum of per-class terms, the optimum
+ *  is found exactly by dynamic programming over the histogram (O(levels x
+ *  256^2) per channel) using prefix sums of the histogram.
+ *
+ *  \param[in] src          source cv::Mat of CV_8UC1 or CV_8UC3
+ *  \param[in] count        number of thresholds per channel [1, 4]
+ *  \param[out] thresholds  increasing thresholds for each channel in a
+ *                          cv::Mat(channels, count) of CV_32SC1, grey
+ *                          levels less than or equal to threshold k (and
+ *                          greater than threshold k - 1) belong to class k
+ */
+bool MultilevelOtsusThreshold(const cv::Mat& src, const int count,
+                              cv::Mat& thresholds);
 }
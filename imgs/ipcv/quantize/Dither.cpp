@@ -0,0 +1,352 @@
+/** Implementation file for ordered and error-diffusion dithering
+ *
+ *  \file ipcv/quantize/Dither.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "Dither.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+// Narrowest block of columns handed to a row of the error-diffusion
+// wavefront (narrower blocks give more parallelism but more waves)
+const int kMinBlockWidth = 64;
+
+// Evenly spaced output levels of a quantizer
+struct Levels {
+    float to_index;  // (levels - 1) / 255
+    float to_value;  // 255 / (levels - 1)
+    int max_index;
+};
+
+// Floyd-Steinberg error diffusion of the pixels [begin, end) of a row,
+// visited in the direction of step (+1 or -1).  current holds the errors
+// diffused into this row and below those of the next row, both indexed
+// like the row elements (with one pixel of padding on either side).
+void DiffuseSpan(const uint8_t* src, uint8_t* dst, float* current,
+                 float* below, const int begin, const int end, const int step,
+                 const int channels, const Levels& levels) {
+    const int ahead = step * channels;
+    for (int c = begin; c != end; c += step) {
+        for (int b = 0; b < channels; b++) {
+            const int i = c * channels + b;
+            float x = min(max(src[i] + current[i], 0.f), 255.f);
+            int k = min(static_cast<int>(x * levels.to_index + 0.5f),
+                        levels.max_index);
+            dst[i] = k;
+            float e = (x - k * levels.to_value) * (1.f / 16);
+            current[i + ahead] += 7 * e;
+            below[i - ahead] += 3 * e;
+            below[i] += 5 * e;
+            below[i + ahead] += e;
+        }
+    }
+}
+
+// Ordered dithering of n consecutive row elements, thresholds holds the
+// threshold of every element of a period of the map row (extended by 16
+// elements so that a vector may start anywhere within the period)
+void OrderedSpan(const uint8_t* src, uint8_t* dst, const int n,
+                 const float* thresholds, const int period, const float scale,
+                 const int max_index) {
+    int i = 0;
+#if defined(__SSE2__)
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128i top = _mm_set1_epi8(static_cast<char>(max_index));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const float* t = thresholds + i % period;
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i k[4];
+        const __m128i words[4] = {
+            _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+            _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)};
+        for (int q = 0; q < 4; q++) {
+            __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(words[q]), s);
+            k[q] = _mm_cvttps_epi32(_mm_add_ps(x, _mm_loadu_ps(t + 4 * q)));
+        }
+        __m128i levels = _mm_packus_epi16(_mm_packs_epi32(k[0], k[1]),
+                                          _mm_packs_epi32(k[2], k[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_min_epu8(levels, top));
+    }
+#endif
+    for (; i < n; i++) {
+        float x = static_cast<float>(src[i]) * scale;
+        int k = static_cast<int>(x + thresholds[i % period]);
+        dst[i] = min(k, max_index);
+    }
+}
+
+// Generate a blue-noise threshold map with the void-and-cluster method:
+// a random pattern of minority pixels is relaxed by repeatedly moving its
+// tightest cluster into its largest void, the pixels are then ranked by
+// removing tightest clusters from (and adding pixels into the largest
+// voids of) that pattern
+cv::Mat GenerateBlueNoise(const int size, const double sigma) {
+    const int area = size * size;
+
+    // Toroidal Gaussian energy of a pixel at the origin
+    vector<float> kernel(area);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int dy = min(y, size - y);
+            int dx = min(x, size - x);
+            kernel[y * size + x] = exp(-(dx * dx + dy * dy) /
+                                       (2 * sigma * sigma));
+        }
+    }
+
+    vector<uint8_t> pattern(area, 0);
+    vector<float> energy(area, 0);
+    auto toggle = [&](const int p, const bool on) {
+        pattern[p] = on;
+        const float sign = on ? 1.f : -1.f;
+        const int py = p / size;
+        const int px = p % size;
+        for (int y = 0; y < size; y++) {
+            const float* k = &kernel[((y - py + size) % size) * size];
+            float* e = &energy[y * size];
+            for (int x = 0; x < size; x++) {
+                e[x] += sign * k[(x - px + size) % size];
+            }
+        }
+    };
+    auto tightest_cluster = [&]() {
+        int best = -1;
+        for (int p = 0; p < area; p++) {
+            if (pattern[p] && (best < 0 || energy[p] > energy[best])) {
+                best = p;
+            }
+        }
+        return best;
+    };
+    auto largest_void = [&]() {
+        int best = -1;
+        for (int p = 0; p < area; p++) {
+            if (!pattern[p] && (best < 0 || energy[p] < energy[best])) {
+                best = p;
+            }
+        }
+        return best;
+    };
+
+    // Initial binary pattern (fixed seed, so every process generates the
+    // same map)
+    const int ones = area / 10;
+    mt19937 generator(0x1b1u);
+    uniform_int_distribution<int> position(0, area - 1);
+    for (int placed = 0; placed < ones;) {
+        int p = position(generator);
+        if (!pattern[p]) {
+            toggle(p, true);
+            placed++;
+        }
+    }
+    while (true) {
+        int cluster = tightest_cluster();
+        toggle(cluster, false);
+        int hole = largest_void();
+        toggle(hole, true);
+        if (hole == cluster) {
+            break;
+        }
+    }
+    const vector<uint8_t> prototype = pattern;
+    const vector<float> prototype_energy = energy;
+
+    vector<int> rank(area);
+    for (int r = ones - 1; r >= 0; r--) {
+        int cluster = tightest_cluster();
+        toggle(cluster, false);
+        rank[cluster] = r;
+    }
+    pattern = prototype;
+    energy = prototype_energy;
+    for (int r = ones; r < area; r++) {
+        int hole = largest_void();
+        toggle(hole, true);
+        rank[hole] = r;
+    }
+
+    cv::Mat map(size, size, CV_32FC1);
+    for (int p = 0; p < area; p++) {
+        map.at<float>(p / size, p % size) = (rank[p] + 0.5f) / area;
+    }
+    return map;
+}
+}
+
+bool ErrorDiffusionDither(const cv::Mat& src, const int quantization_levels,
+                          cv::Mat& dst, const bool serpentine) {
+    if (src.depth() != CV_8U || src.channels() > 4 || src.empty()) {
+        cerr << "Dithering requires a non-empty CV_8U source image with at "
+             << "most 4 channels" << endl;
+        return false;
+    }
+    if (quantization_levels < 2 || quantization_levels > 256) {
+        cerr << "Dithering quantization levels must be in [2, 256]" << endl;
+        return false;
+    }
+
+    const Levels levels = {(quantization_levels - 1) / 255.f,
+                           255.f / (quantization_levels - 1),
+                           quantization_levels - 1};
+    const int rows = src.rows;
+    const int cols = src.cols;
+    const int channels = src.channels();
+    const int width = (cols + 2) * channels;
+
+    // Keep a reference to the source in case dst is the source image
+    const cv::Mat source = src;
+    dst.create(src.size(), src.type());
+
+    // Columns are split into blocks; row r processes block j on wave
+    // 2 r + j, after the blocks of row r - 1 it receives errors from
+    int block = max(kMinBlockWidth, cols / (4 * cv::getNumThreads()));
+    const int blocks = (cols + block - 1) / block;
+    const bool wavefront = !serpentine && blocks > 1 && rows > 1;
+    if (!wavefront) {
+        block = cols;
+    }
+
+    // Rolling buffer of the errors diffused into the rows in flight
+    const int slots = wavefront ? blocks / 2 + 3 : 2;
+    vector<float> errors(slots * width, 0);
+    auto row_errors = [&](const int r) {
+        return &errors[(r % slots) * width + channels];
+    };
+    auto diffuse = [&](const int r, const int j) {
+        float* current = row_errors(r);
+        float* below = row_errors(r + 1);
+        if (j == 0) {
+            fill(below - channels, below - channels + width, 0.f);
+        }
+        const uint8_t* s = source.ptr<uint8_t>(r);
+        uint8_t* d = dst.ptr<uint8_t>(r);
+        if (serpentine && r % 2 == 1) {
+            DiffuseSpan(s, d, current, below, cols - 1, -1, -1, channels,
+                        levels);
+        } else {
+            DiffuseSpan(s, d, current, below, j * block,
+                        min((j + 1) * block, cols), 1, channels, levels);
+        }
+    };
+
+    if (!wavefront) {
+        for (int r = 0; r < rows; r++) {
+            diffuse(r, 0);
+        }
+        return true;
+    }
+
+    const int waves = 2 * (rows - 1) + blocks;
+    for (int wave = 0; wave < waves; wave++) {
+        const int first = max((wave - blocks + 2) / 2, 0);
+        const int last = min(wave / 2, rows - 1);
+        cv::parallel_for_(cv::Range(first, last + 1),
+                          [&](const cv::Range& range) {
+                              for (int r = range.start; r < range.end; r++) {
+                                  diffuse(r, wave - 2 * r);
+                              }
+                          });
+    }
+
+    return true;
+}
+
+bool OrderedDither(const cv::Mat& src, const int quantization_levels,
+                   const cv::Mat& threshold_map, cv::Mat& dst) {
+    if (src.depth() != CV_8U || src.channels() > 4) {
+        cerr << "Dithering requires a CV_8U source image with at most 4 "
+             << "channels" << endl;
+        return false;
+    }
+    if (quantization_levels < 2 || quantization_levels > 256) {
+        cerr << "Dithering quantization levels must be in [2, 256]" << endl;
+        return false;
+    }
+    if (threshold_map.type() != CV_32FC1 || threshold_map.empty()) {
+        cerr << "Dithering threshold map must be a non-empty CV_32FC1 matrix"
+             << endl;
+        return false;
+    }
+
+    // Expand every map row to the thresholds of the row elements (each
+    // threshold repeated for every channel) over one period of the map
+    const int channels = src.channels();
+    const int period = threshold_map.cols * channels;
+    cv::Mat thresholds(threshold_map.rows, period + 16, CV_32FC1);
+    for (int y = 0; y < threshold_map.rows; y++) {
+        const float* map = threshold_map.ptr<float>(y);
+        float* t = thresholds.ptr<float>(y);
+        for (int k = 0; k < period + 16; k++) {
+            t[k] = map[(k / channels) % threshold_map.cols];
+        }
+    }
+
+    const float scale = (quantization_levels - 1) / 255.f;
+    const int n = src.cols * channels;
+    dst.create(src.size(), src.type());
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; r++) {
+            OrderedSpan(src.ptr<uint8_t>(r), dst.ptr<uint8_t>(r), n,
+                        thresholds.ptr<float>(r % thresholds.rows), period,
+                        scale, quantization_levels - 1);
+        }
+    });
+
+    return true;
+}
+
+cv::Mat BayerThresholdMap(const int size) {
+    if (size < 1 || (size & (size - 1)) != 0) {
+        cerr << "Bayer threshold map size must be a power of 2" << endl;
+        return cv::Mat();
+    }
+
+    // M(2n) = [4 M(n), 4 M(n) + 2; 4 M(n) + 3, 4 M(n) + 1]
+    const int offsets[2][2] = {{0, 2}, {3, 1}};
+    cv::Mat_<int> rank(1, 1, 0);
+    while (rank.rows < size) {
+        const int n = rank.rows;
+        cv::Mat_<int> next(2 * n, 2 * n);
+        for (int y = 0; y < 2 * n; y++) {
+            for (int x = 0; x < 2 * n; x++) {
+                next(y, x) = 4 * rank(y % n, x % n) + offsets[y / n][x / n];
+            }
+        }
+        rank = next;
+    }
+
+    cv::Mat map(size, size, CV_32FC1);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            map.at<float>(y, x) = (rank(y, x) + 0.5f) / (size * size);
+        }
+    }
+    return map;
+}
+
+const cv::Mat& BlueNoiseThresholdMap() {
+    static const cv::Mat map = GenerateBlueNoise(64, 1.5);
+    return map;
+}
+}
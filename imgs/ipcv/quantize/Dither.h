@@ -0,0 +1,75 @@
+/** Interface file for ordered and error-diffusion dithering
+ *
+ *  \file ipcv/quantize/Dither.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/** Quantize an image using Floyd-Steinberg error diffusion
+ *
+ *  Each pixel is quantized to the nearest of the evenly spaced output
+ *  levels and the quantization error is diffused to the unprocessed
+ *  neighbours (7/16 ahead, 3/16, 5/16 and 1/16 below), keeping only a
+ *  small rolling buffer of row errors.  In raster order the rows are
+ *  processed as a wavefront (each row trails the row above by two blocks
+ *  of columns) so that several rows are dithered in parallel.  Serpentine
+ *  order alternates the direction of every row, which avoids directional
+ *  artifacts but processes the rows sequentially.
+ *
+ *  \param[in] src                 source cv::Mat of CV_8UC1 to CV_8UC4
+ *  \param[in] quantization_levels the number of output levels [2, 256]
+ *  \param[out] dst                destination cv::Mat of the source type
+ *                                 holding level indices [0, levels - 1]
+ *  \param[in] serpentine          process the rows in serpentine order
+ *                                 [default is false, parallel raster order]
+ *
+ *  \return a boolean indicating that dithering has been carried out
+ *          without error
+ */
+bool ErrorDiffusionDither(const cv::Mat& src, const int quantization_levels,
+                          cv::Mat& dst, const bool serpentine = false);
+
+/** Quantize an image using ordered dithering with a tiled threshold map
+ *
+ *  A pixel of value v is mapped to level floor(v (levels - 1) / 255 + t),
+ *  with t the threshold map value at the pixel location (modulo the map
+ *  size).  Every pixel is independent, so rows are processed in parallel
+ *  and each row is vectorized.
+ *
+ *  \param[in] src                 source cv::Mat of CV_8UC1 to CV_8UC4
+ *  \param[in] quantization_levels the number of output levels [2, 256]
+ *  \param[in] threshold_map       cv::Mat of CV_32FC1 thresholds in [0, 1)
+ *                                 (e.g. BayerThresholdMap or
+ *                                 BlueNoiseThresholdMap)
+ *  \param[out] dst                destination cv::Mat of the source type
+ *                                 holding level indices [0, levels - 1]
+ *
+ *  \return a boolean indicating that dithering has been carried out
+ *          without error
+ */
+bool OrderedDither(const cv::Mat& src, const int quantization_levels,
+                   const cv::Mat& threshold_map, cv::Mat& dst);
+
+/** Bayer (recursive dispersed-dot) threshold map
+ *
+ *  \param[in] size  width and height of the map, a power of 2 [default is 8]
+ *
+ *  \return          cv::Mat of CV_32FC1 thresholds (rank + 0.5) / size^2
+ */
+cv::Mat BayerThresholdMap(const int size = 8);
+
+/** Blue-noise threshold map
+ *
+ *  The 64 x 64 map is generated once per process with the void-and-cluster
+ *  method (toroidal Gaussian energy, sigma 1.5) and is then shared.
+ *
+ *  \return  cv::Mat of CV_32FC1 thresholds (rank + 0.5) / 64^2
+ */
+const cv::Mat& BlueNoiseThresholdMap();
+}
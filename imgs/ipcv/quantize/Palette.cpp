@@ -0,0 +1,347 @@
+/** Implementation file for palette (color) quantization
+ *
+ *  \file ipcv/quantize/Palette.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "Palette.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include <opencv2/imgproc.hpp>
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+// Bits per channel of the RGB lookup table used to map pixels to the
+// palette (32 x 32 x 32 cells of 8 x 8 x 8 grey levels)
+const int kLutBits = 5;
+
+// Convert a list of 8-bit BGR colors to CIE L*a*b*
+vector<cv::Vec3f> BgrToLab(const vector<cv::Vec3b>& bgr) {
+    cv::Mat colors(1, static_cast<int>(bgr.size()), CV_8UC3);
+    copy(bgr.begin(), bgr.end(), colors.ptr<cv::Vec3b>(0));
+    cv::Mat normalized;
+    colors.convertTo(normalized, CV_32F, 1 / 255.0);
+    cv::Mat lab;
+    cv::cvtColor(normalized, lab, cv::COLOR_BGR2Lab);
+    const cv::Vec3f* p = lab.ptr<cv::Vec3f>(0);
+    return vector<cv::Vec3f>(p, p + bgr.size());
+}
+
+// Convert a list of CIE L*a*b* colors to 8-bit BGR
+vector<cv::Vec3b> LabToBgr(const vector<cv::Vec3f>& lab) {
+    cv::Mat colors(1, static_cast<int>(lab.size()), CV_32FC3);
+    copy(lab.begin(), lab.end(), colors.ptr<cv::Vec3f>(0));
+    cv::Mat normalized;
+    cv::cvtColor(colors, normalized, cv::COLOR_Lab2BGR);
+    cv::Mat bgr;
+    normalized.convertTo(bgr, CV_8U, 255);
+    const cv::Vec3b* p = bgr.ptr<cv::Vec3b>(0);
+    return vector<cv::Vec3b>(p, p + lab.size());
+}
+
+float SquaredDistance(const cv::Vec3f& a, const cv::Vec3f& b) {
+    float d0 = a[0] - b[0];
+    float d1 = a[1] - b[1];
+    float d2 = a[2] - b[2];
+    return d0 * d0 + d1 * d1 + d2 * d2;
+}
+
+// k-d tree over a (small) set of 3-D points for exact nearest neighbour
+// queries, ties are resolved in favour of the lower point index
+class KdTree {
+ public:
+    explicit KdTree(const vector<cv::Vec3f>& points) : points_(points) {
+        vector<int> order(points.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            order[i] = static_cast<int>(i);
+        }
+        nodes_.reserve(points.size());
+        root_ = Build(order.data(), order.data() + order.size());
+    }
+
+    int Nearest(const cv::Vec3f& p) const {
+        int best = -1;
+        float best_distance = numeric_limits<float>::max();
+        Search(root_, p, best, best_distance);
+        return best;
+    }
+
+ private:
+    struct Node {
+        int point;
+        int axis;
+        int left;
+        int right;
+    };
+
+    // Split at the median of the axis of largest spread
+    int Build(int* begin, int* end) {
+        if (begin == end) {
+            return -1;
+        }
+        float low[3] = {numeric_limits<float>::max(),
+                        numeric_limits<float>::max(),
+                        numeric_limits<float>::max()};
+        float high[3] = {numeric_limits<float>::lowest(),
+                         numeric_limits<float>::lowest(),
+                         numeric_limits<float>::lowest()};
+        for (int* i = begin; i != end; i++) {
+            for (int a = 0; a < 3; a++) {
+                low[a] = min(low[a], points_[*i][a]);
+                high[a] = max(high[a], points_[*i][a]);
+            }
+        }
+        int axis = 0;
+        for (int a = 1; a < 3; a++) {
+            if (high[a] - low[a] > high[axis] - low[axis]) {
+                axis = a;
+            }
+        }
+
+        int* middle = begin + (end - begin) / 2;
+        nth_element(begin, middle, end, [&](const int a, const int b) {
+            return points_[a][axis] < points_[b][axis];
+        });
+        int node = static_cast<int>(nodes_.size());
+        nodes_.push_back({*middle, axis, -1, -1});
+        int left = Build(begin, middle);
+        int right = Build(middle + 1, end);
+        nodes_[node].left = left;
+        nodes_[node].right = right;
+        return node;
+    }
+
+    void Search(const int node, const cv::Vec3f& p, int& best,
+                float& best_distance) const {
+        if (node < 0) {
+            return;
+        }
+        const Node& n = nodes_[node];
+        float distance = SquaredDistance(points_[n.point], p);
+        if (distance < best_distance ||
+            (distance == best_distance && n.point < best)) {
+            best = n.point;
+            best_distance = distance;
+        }
+        float difference = p[n.axis] - points_[n.point][n.axis];
+        int near = difference < 0 ? n.left : n.right;
+        int far = difference < 0 ? n.right : n.left;
+        Search(near, p, best, best_distance);
+        if (difference * difference <= best_distance) {
+            Search(far, p, best, best_distance);
+        }
+    }
+
+    vector<cv::Vec3f> points_;
+    vector<Node> nodes_;
+    int root_;
+};
+
+// Flatten a palette of CV_8UC3 into a list of colors
+vector<cv::Vec3b> PaletteColors(const cv::Mat& palette) {
+    vector<cv::Vec3b> colors;
+    for (int r = 0; r < palette.rows; r++) {
+        const cv::Vec3b* p = palette.ptr<cv::Vec3b>(r);
+        colors.insert(colors.end(), p, p + palette.cols);
+    }
+    return colors;
+}
+
+// k-means++ seeding followed by Lloyd iterations
+vector<cv::Vec3f> KMeans(const vector<cv::Vec3f>& samples, const int k,
+                         const int iterations) {
+    const int n = static_cast<int>(samples.size());
+    mt19937 generator(0x5eedu);
+
+    // Each further centre is drawn with probability proportional to the
+    // squared distance of a sample to its nearest centre
+    vector<cv::Vec3f> centers;
+    centers.push_back(
+        samples[uniform_int_distribution<int>(0, n - 1)(generator)]);
+    vector<float> distances(n, numeric_limits<float>::max());
+    while (static_cast<int>(centers.size()) < k) {
+        double total = 0;
+        for (int i = 0; i < n; i++) {
+            distances[i] =
+                min(distances[i], SquaredDistance(samples[i], centers.back()));
+            total += distances[i];
+        }
+        if (total <= 0) {
+            // Fewer distinct colors than requested
+            break;
+        }
+        double target =
+            uniform_real_distribution<double>(0, total)(generator);
+        int chosen = n - 1;
+        for (int i = 0; i < n; i++) {
+            target -= distances[i];
+            if (target < 0 && distances[i] > 0) {
+                chosen = i;
+                break;
+            }
+        }
+        centers.push_back(samples[chosen]);
+    }
+
+    vector<int> labels(n, -1);
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        KdTree tree(centers);
+        int changed = 0;
+        mutex changed_mutex;
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range& range) {
+            int stripe_changed = 0;
+            for (int i = range.start; i < range.end; i++) {
+                int label = tree.Nearest(samples[i]);
+                stripe_changed += label != labels[i];
+                labels[i] = label;
+            }
+            lock_guard<mutex> lock(changed_mutex);
+            changed += stripe_changed;
+        });
+        if (changed == 0) {
+            break;
+        }
+
+        // Empty clusters keep their previous centre
+        vector<cv::Vec3d> sums(centers.size(), cv::Vec3d(0, 0, 0));
+        vector<int> counts(centers.size(), 0);
+        for (int i = 0; i < n; i++) {
+            for (int a = 0; a < 3; a++) {
+                sums[labels[i]][a] += samples[i][a];
+            }
+            counts[labels[i]]++;
+        }
+        for (size_t c = 0; c < centers.size(); c++) {
+            if (counts[c] > 0) {
+                for (int a = 0; a < 3; a++) {
+                    centers[c][a] = static_cast<float>(sums[c][a] / counts[c]);
+                }
+            }
+        }
+    }
+    return centers;
+}
+}
+
+bool PaletteQuantize(const cv::Mat& src, const int colors, cv::Mat& indices,
+                     cv::Mat& palette, const int samples,
+                     const int iterations) {
+    if (src.type() != CV_8UC3 || src.empty()) {
+        cerr << "Palette quantization requires a non-empty CV_8UC3 source "
+             << "image" << endl;
+        return false;
+    }
+    if (colors < 1 || colors > 256) {
+        cerr << "Palette colors must be in [1, 256]" << endl;
+        return false;
+    }
+
+    // Regularly subsample the pixels
+    const size_t total = static_cast<size_t>(src.rows) * src.cols;
+    const size_t step = max(total / max(samples, 1), static_cast<size_t>(1));
+    vector<cv::Vec3b> sampled;
+    sampled.reserve(total / step + 1);
+    for (size_t i = 0; i < total; i += step) {
+        sampled.push_back(src.ptr<cv::Vec3b>(i / src.cols)[i % src.cols]);
+    }
+
+    vector<cv::Vec3f> centers =
+        KMeans(BgrToLab(sampled), min(colors, static_cast<int>(sampled.size())),
+               max(iterations, 1));
+    vector<cv::Vec3b> bgr = LabToBgr(centers);
+    palette.create(static_cast<int>(bgr.size()), 1, CV_8UC3);
+    for (size_t c = 0; c < bgr.size(); c++) {
+        palette.at<cv::Vec3b>(static_cast<int>(c), 0) = bgr[c];
+    }
+
+    return MapToPalette(src, palette, indices);
+}
+
+bool MapToPalette(const cv::Mat& src, const cv::Mat& palette,
+                  cv::Mat& indices) {
+    if (src.type() != CV_8UC3) {
+        cerr << "Palette mapping requires a CV_8UC3 source image" << endl;
+        return false;
+    }
+    if (palette.type() != CV_8UC3 || palette.empty() ||
+        palette.total() > 256) {
+        cerr << "Palette must be a CV_8UC3 matrix of 1 to 256 colors" << endl;
+        return false;
+    }
+
+    KdTree tree(BgrToLab(PaletteColors(palette)));
+
+    // Nearest palette color of the centre of every lookup table cell
+    const int cells = 1 << (3 * kLutBits);
+    const int shift = 8 - kLutBits;
+    vector<cv::Vec3b> centres(cells);
+    for (int cell = 0; cell < cells; cell++) {
+        for (int a = 0; a < 3; a++) {
+            int level = (cell >> (a * kLutBits)) & ((1 << kLutBits) - 1);
+            centres[cell][a] = (level << shift) + (1 << (shift - 1));
+        }
+    }
+    const vector<cv::Vec3f> lab = BgrToLab(centres);
+    vector<uint8_t> lut(cells);
+    cv::parallel_for_(cv::Range(0, cells), [&](const cv::Range& range) {
+        for (int cell = range.start; cell < range.end; cell++) {
+            lut[cell] = tree.Nearest(lab[cell]);
+        }
+    });
+
+    indices.create(src.size(), CV_8UC1);
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; r++) {
+            const uint8_t* s = src.ptr<uint8_t>(r);
+            uint8_t* d = indices.ptr<uint8_t>(r);
+            for (int c = 0; c < src.cols; c++, s += 3) {
+                d[c] = lut[(s[0] >> shift) |
+                           ((s[1] >> shift) << kLutBits) |
+                           ((s[2] >> shift) << (2 * kLutBits))];
+            }
+        }
+    });
+
+    return true;
+}
+
+bool ApplyPalette(const cv::Mat& indices, const cv::Mat& palette,
+                  cv::Mat& dst) {
+    if (indices.type() != CV_8UC1) {
+        cerr << "Palette indices must be a CV_8UC1 image" << endl;
+        return false;
+    }
+    if (palette.type() != CV_8UC3 || palette.total() > 256) {
+        cerr << "Palette must be a CV_8UC3 matrix of at most 256 colors"
+             << endl;
+        return false;
+    }
+
+    vector<cv::Vec3b> colors = PaletteColors(palette);
+    colors.resize(256, cv::Vec3b(0, 0, 0));
+
+    dst.create(indices.size(), CV_8UC3);
+    cv::parallel_for_(cv::Range(0, indices.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; r++) {
+            const uint8_t* s = indices.ptr<uint8_t>(r);
+            cv::Vec3b* d = dst.ptr<cv::Vec3b>(r);
+            for (int c = 0; c < indices.cols; c++) {
+                d[c] = colors[s[c]];
+            }
+        }
+    });
+
+    return true;
+}
+}
@@ -0,0 +1,68 @@
+/** Interface file for palette (color) quantization
+ *
+ *  \file ipcv/quantize/Palette.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/** Quantize a color image to a palette of at most N colors
+ *
+ *  The palette is found by k-means clustering (k-means++ seeding) of a
+ *  regularly subsampled set of the pixels in CIE L*a*b*, so that colors
+ *  are grouped by perceptual rather than RGB distance.  The pixels are
+ *  then assigned to the palette with MapToPalette.
+ *
+ *  \param[in] src         source cv::Mat of CV_8UC3
+ *  \param[in] colors      maximum number of palette colors [1, 256]
+ *  \param[out] indices    destination cv::Mat of CV_8UC1 holding the
+ *                         palette index of every pixel
+ *  \param[out] palette    cv::Mat(colors, 1) of CV_8UC3 palette colors
+ *                         (fewer rows if the samples hold fewer colors)
+ *  \param[in] samples     number of pixels used for clustering
+ *                         [default is 65536]
+ *  \param[in] iterations  maximum number of k-means iterations
+ *                         [default is 10]
+ *
+ *  \return a boolean indicating that quantization has been carried out
+ *          without error
+ */
+bool PaletteQuantize(const cv::Mat& src, const int colors, cv::Mat& indices,
+                     cv::Mat& palette, const int samples = 65536,
+                     const int iterations = 10);
+
+/** Assign every pixel of a color image to its nearest palette color
+ *
+ *  Nearest colors (in CIE L*a*b*) are found with a k-d tree built over the
+ *  palette.  The tree is queried once for every cell of a 32 x 32 x 32
+ *  RGB lookup table (cell centres), and the pixels (processed in parallel
+ *  rows) are then mapped through that table.
+ *
+ *  \param[in] src       source cv::Mat of CV_8UC3
+ *  \param[in] palette   cv::Mat of CV_8UC3 holding at most 256 colors
+ *  \param[out] indices  destination cv::Mat of CV_8UC1 palette indices
+ *
+ *  \return a boolean indicating that the mapping has been carried out
+ *          without error
+ */
+bool MapToPalette(const cv::Mat& src, const cv::Mat& palette,
+                  cv::Mat& indices);
+
+/** Render a palette index image
+ *
+ *  \param[in] indices   source cv::Mat of CV_8UC1 palette indices (indices
+ *                       beyond the palette are rendered black)
+ *  \param[in] palette   cv::Mat of CV_8UC3 holding at most 256 colors
+ *  \param[out] dst      destination cv::Mat of CV_8UC3
+ *
+ *  \return a boolean indicating that the rendering has been carried out
+ *          without error
+ */
+bool ApplyPalette(const cv::Mat& indices, const cv::Mat& palette,
+                  cv::Mat& dst);
+}
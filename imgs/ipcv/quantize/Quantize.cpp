@@ -6,11 +6,20 @@
  */
 
 #include "Quantize.h"
-#include <bitset>
+
+#include <algorithm>
 #include <iostream>
 
+#include "Dither.h"
+#include "Palette.h"
+#include "imgs/ipcv/utils/ApplyLut.h"
+
 using namespace std;
 
+namespace ipcv {
+
+namespace {
+
 /** Perform uniform grey-level quantization on a color image
  *
  *  \param[in] src                 source cv::Mat of CV_8UC3
@@ -18,28 +27,46 @@ using namespace std;
  *                                 the image
  *  \param[out] dst                destination cv:Mat of CV_8UC3
  */
-
 void Uniform(const cv::Mat& src, const int quantization_levels, cv::Mat& dst) {
-
-    dst.create(src.size(), src.type());
-    // Find the Maximum pixel value for the source's given bit depth
-    int maxVal = 255;
     // Calculate the "width" of the quantization levels
-    int binSize = maxVal/quantization_levels;
-    
-    for(int i = 0; i < src.rows; i++){
-        for(int j = 0; j < src.cols; j++){
-            // Grab the pixel(s) value at every location in the image
-            auto value = src.at<cv::Vec3b>(i,j);
-            // Perform the quantization by binning the pixels via integer division
-            value[0] = value[0]/binSize;
-            value[1] = value[1]/binSize;
-            value[2] = value[2]/binSize;
-            // Assign the quantized values to the destination image (to be scaled back later)
-            dst.at<cv::Vec3b>(i,j)[0] = value[0];
-            dst.at<cv::Vec3b>(i,j)[1] = value[1];
-            dst.at<cv::Vec3b>(i,j)[2] = value[2];
+    int maxVal = 255;
+    int binSize = max(maxVal / quantization_levels, 1);
+
+    // Bin the pixels via integer division (to be scaled back later), the
+    // division is tabulated once and applied with the vectorized LUT path
+    cv::Mat lut(1, 256, CV_8UC1);
+    for (int dc = 0; dc < 256; dc++) {
+        lut.at<uint8_t>(0, dc) = dc / binSize;
+    }
+    ipcv::ApplyLut(src, lut, dst);
+}
+
+/** Perform improved grey scale quantization on a single row
+ *
+ *  The lower (8 - bits) bits of each sum are carried to the next pixel
+ *  of the same channel along the row and the upper bits are kept.  As in
+ *  the classic formulation, the carry is not added to a pixel whose upper
+ *  bits are all ones so the sum never overflows.
+ *
+ *  \tparam bits   number of bits kept [0, 8], 2^bits levels
+ */
+template <int bits>
+void IgsRow(const uint8_t* src, uint8_t* dst, const int cols,
+            const int channels) {
+    const int shift = 8 - bits;
+    const int mask = (1 << shift) - 1;
+    const int saturated = 256 - (1 << shift);
+
+    int carry[4] = {0, 0, 0, 0};
+    for (int c = 0; c < cols; c++) {
+        for (int b = 0; b < channels; b++) {
+            int value = src[b];
+            int sum = value >= saturated ? value : value + carry[b];
+            dst[b] = sum >> shift;
+            carry[b] = sum & mask;
         }
+        src += channels;
+        dst += channels;
     }
 }
 
@@ -51,104 +78,40 @@ void Uniform(const cv::Mat& src, const int quantization_levels, cv::Mat& dst) {
  *  \param[out] dst                destination cv:Mat of CV_8UC3
  */
 void Igs(const cv::Mat& src, const int quantization_levels, cv::Mat& dst) {
-    
-    dst.create(src.size(), CV_8UC3);
-    // Find the number of quantized bit levels by calculating the log base 2 floor
-    // ex: log2(9) = 3
-    const int bitLevels = log2(quantization_levels);
-    
-    vector<string> upperBits(3);
-    vector<string> lowerBits(3);
-    vector<string> bits(3);
-    // Instantiate the first upper and lower bit values to be 0
-    vector<long> upperBitsVal(3, 0);
-    vector<long> lowerBitsVal(3, 0);
-    vector<long> newVal(3);
-    for(int i = 0; i < src.rows; i++){
-        for(int j = 0; j < src.cols; j++){
-            // Grab the pixel(s) value at every location in the image
-            auto value = src.at<cv::Vec3b>(i,j);
-            // Add the lower bit value of the previous pixel
-            newVal[0] = value[0]+lowerBitsVal[0];
-            newVal[1] = value[1]+lowerBitsVal[1];
-            newVal[2] = value[2]+lowerBitsVal[2];
-            // Convert the current pixel value to binary
-            bits[0] = bitset<8>(newVal[0]).to_string();
-            bits[1] = bitset<8>(newVal[1]).to_string();
-            bits[2] = bitset<8>(newVal[2]).to_string();
-            // Segment the new current bit into it's upper and lower portions
-            upperBits[0] = bits[0].substr(0,8-bitLevels);
-            upperBits[1] = bits[1].substr(0,8-bitLevels);
-            upperBits[2] = bits[2].substr(0,8-bitLevels);
-            lowerBits[0] = bits[0].substr(8-bitLevels,string::npos);
-            lowerBits[1] = bits[1].substr(8-bitLevels,string::npos);
-            lowerBits[2] = bits[2].substr(8-bitLevels,string::npos);
-            // Perform the quantization by assigning the upper bits to the destination image and sending the lower bits to the next pixel
-            if(bitLevels == 7){
-                dst.at<cv::Vec3b>(i,j)[0] = bitset<7>(upperBits[0]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[1] = bitset<7>(upperBits[1]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[2] = bitset<7>(upperBits[2]).to_ulong();
-                lowerBitsVal[0] = bitset<1>(lowerBits[0]).to_ulong();
-                lowerBitsVal[1] = bitset<1>(lowerBits[1]).to_ulong();
-                lowerBitsVal[2] = bitset<1>(lowerBits[2]).to_ulong();
-            }
-            else if (bitLevels == 6){
-                dst.at<cv::Vec3b>(i,j)[0] = bitset<6>(upperBits[0]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[1] = bitset<6>(upperBits[1]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[2] = bitset<6>(upperBits[2]).to_ulong();
-                lowerBitsVal[0] = bitset<2>(lowerBits[0]).to_ulong();
-                lowerBitsVal[1] = bitset<2>(lowerBits[1]).to_ulong();
-                lowerBitsVal[2] = bitset<2>(lowerBits[2]).to_ulong();
-            }
-            else if (bitLevels == 5){
-                dst.at<cv::Vec3b>(i,j)[0] = bitset<5>(upperBits[0]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[1] = bitset<5>(upperBits[1]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[2] = bitset<5>(upperBits[2]).to_ulong();
-                lowerBitsVal[0] = bitset<3>(lowerBits[0]).to_ulong();
-                lowerBitsVal[1] = bitset<3>(lowerBits[1]).to_ulong();
-                lowerBitsVal[2] = bitset<3>(lowerBits[2]).to_ulong();
-            }
-            else if (bitLevels == 4){
-                dst.at<cv::Vec3b>(i,j)[0] = bitset<4>(upperBits[0]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[1] = bitset<4>(upperBits[1]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[2] = bitset<4>(upperBits[2]).to_ulong();
-                lowerBitsVal[0] = bitset<4>(lowerBits[0]).to_ulong();
-                lowerBitsVal[1] = bitset<4>(lowerBits[1]).to_ulong();
-                lowerBitsVal[2] = bitset<4>(lowerBits[2]).to_ulong();
-            }
-            else if (bitLevels == 3){
-                dst.at<cv::Vec3b>(i,j)[0] = bitset<3>(upperBits[0]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[1] = bitset<3>(upperBits[1]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[2] = bitset<3>(upperBits[2]).to_ulong();
-                lowerBitsVal[0] = bitset<5>(lowerBits[0]).to_ulong();
-                lowerBitsVal[1] = bitset<5>(lowerBits[1]).to_ulong();
-                lowerBitsVal[2] = bitset<5>(lowerBits[2]).to_ulong();
-            }
-            else if (bitLevels == 2){
-                dst.at<cv::Vec3b>(i,j)[0] = bitset<2>(upperBits[0]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[1] = bitset<2>(upperBits[1]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[2] = bitset<2>(upperBits[2]).to_ulong();
-                lowerBitsVal[0] = bitset<2>(lowerBits[0]).to_ulong();
-                lowerBitsVal[1] = bitset<2>(lowerBits[1]).to_ulong();
-                lowerBitsVal[2] = bitset<2>(lowerBits[2]).to_ulong();
-            }
-            else if (bitLevels == 1){
-                dst.at<cv::Vec3b>(i,j)[0] = bitset<1>(upperBits[0]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[1] = bitset<1>(upperBits[1]).to_ulong();
-                dst.at<cv::Vec3b>(i,j)[2] = bitset<1>(upperBits[2]).to_ulong();
-                lowerBitsVal[0] = bitset<7>(lowerBits[0]).to_ulong();
-                lowerBitsVal[1] = bitset<7>(lowerBits[1]).to_ulong();
-                lowerBitsVal[2] = bitset<7>(lowerBits[2]).to_ulong();
-            }
-        }
+    // Find the number of quantized bit levels by calculating the log base 2
+    // floor, ex: log2(9) = 3
+    int bitLevels = 0;
+    while ((2 << bitLevels) <= quantization_levels && bitLevels < 8) {
+        bitLevels++;
     }
-}
 
-namespace ipcv {
+    typedef void (*Row)(const uint8_t*, uint8_t*, const int, const int);
+    const Row rows[9] = {IgsRow<0>, IgsRow<1>, IgsRow<2>, IgsRow<3>, IgsRow<4>,
+                         IgsRow<5>, IgsRow<6>, IgsRow<7>, IgsRow<8>};
+    const Row row = rows[bitLevels];
+
+    // The error is carried along each row, so the rows are independent
+    const int channels = src.channels();
+    dst.create(src.size(), src.type());
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int r = range.start; r < range.end; r++) {
+            row(src.ptr<uint8_t>(r), dst.ptr<uint8_t>(r), src.cols, channels);
+        }
+    });
+}
+}
 
 bool Quantize(const cv::Mat& src, const int quantization_levels,
               const QuantizationType quantization_type, cv::Mat& dst) {
-  dst.create(src.size(), src.type());
+  if (src.depth() != CV_8U || src.channels() > 4) {
+    cerr << "Quantization requires a CV_8U source image with at most 4 "
+         << "channels" << endl;
+    return false;
+  }
+  if (quantization_levels < 1 || quantization_levels > 256) {
+    cerr << "Quantization levels must be in [1, 256]" << endl;
+    return false;
+  }
 
   switch (quantization_type) {
     case QuantizationType::uniform:
@@ -157,6 +120,20 @@ bool Quantize(const cv::Mat& src, const int quantization_levels,
     case QuantizationType::igs:
       Igs(src, quantization_levels, dst);
       break;
+    case QuantizationType::floyd_steinberg:
+      return ErrorDiffusionDither(src, quantization_levels, dst);
+    case QuantizationType::bayer:
+      return OrderedDither(src, quantization_levels, BayerThresholdMap(8),
+                           dst);
+    case QuantizationType::blue_noise:
+      return OrderedDither(src, quantization_levels, BlueNoiseThresholdMap(),
+                           dst);
+    case QuantizationType::palette: {
+      cv::Mat indices;
+      cv::Mat palette;
+      return PaletteQuantize(src, quantization_levels, indices, palette) &&
+             ApplyPalette(indices, palette, dst);
+    }
     default:
       cerr << "Specified quantization type is unsupported" << endl;
       return false;
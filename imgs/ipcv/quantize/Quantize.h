@@ -13,17 +13,30 @@ namespace ipcv {
 
 /// Available quantization types
 enum class QuantizationType {
-  uniform,  ///< Uniform quantization
-  igs       ///< Improved greyscale quantization
+  uniform,          ///< Uniform quantization
+  igs,              ///< Improved greyscale quantization
+  floyd_steinberg,  ///< Floyd-Steinberg error diffusion dithering
+  bayer,            ///< Ordered dithering with an 8 x 8 Bayer matrix
+  blue_noise,       ///< Ordered dithering with a blue-noise map
+  palette           ///< k-means palette of quantization_levels colors
 };
 
 /** Perform grey-level quantization on a color image
  *
- *  \param[in] src                 source cv::Mat of CV_8UC3
+ *  Improved greyscale (IGS) quantization keeps the upper log2(levels) bits
+ *  of each pixel and carries the remaining lower bits to the next pixel of
+ *  the same channel along the row.  The dithering types quantize to
+ *  evenly spaced levels (see Dither.h) and require at least 2 levels.
+ *  Quantized values are level indices (to be scaled for display), except
+ *  for palette quantization (see Palette.h) of a CV_8UC3 image which
+ *  replaces every pixel by its palette color.
+ *
+ *  \param[in] src                 source cv::Mat of CV_8UC3 (CV_8UC1 to
+ *                                 CV_8UC4 are also accepted)
  *  \param[in] quantization_levels the number of levels to which to quantize
- *                                 the image
+ *                                 the image [1, 256]
  *  \param[in] quantization_type   the quantization method
- *  \param[out] dst                destination cv:Mat of CV_8UC3
+ *  \param[out] dst                destination cv:Mat of the source type
  *
  *  \return a boolean indicating that quantization has been carried out
  *          without error
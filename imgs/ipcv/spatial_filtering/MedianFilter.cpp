@@ -0,0 +1,47 @@
+/** Implementation file for constant-time median filtering
+ *
+ *  \file ipcv/spatial_filtering/MedianFilter.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "MedianFilter.h"
+
+#include <iostream>
+#include <vector>
+#include <opencv2/core.hpp>
+
+#include "imgs/ipcv/utils/SlidingHistogram.h"
+
+using namespace std;
+
+namespace ipcv {
+
+bool MedianFilter(const cv::Mat& src, cv::Mat& dst, const int radius) {
+    if (src.type() != CV_8UC1 && src.type() != CV_8UC3) {
+        cerr << "Median filter requires a CV_8UC1 or CV_8UC3 source image"
+             << endl;
+        return false;
+    }
+
+    const int median_rank = (2 * radius + 1) * (2 * radius + 1) / 2;
+    vector<cv::Mat> channels;
+    cv::split(src, channels);
+    for (auto& channel : channels) {
+        cv::Mat filtered(channel.size(), CV_8UC1);
+        bool status = SlidingHistogram(
+            channel, radius,
+            [&](const int r, const int c, const uint16_t* histogram,
+                const uint16_t* coarse) {
+                filtered.ptr<uint8_t>(r)[c] =
+                    HistogramRank(histogram, coarse, median_rank);
+            });
+        if (!status) {
+            return false;
+        }
+        channel = filtered;
+    }
+    cv::merge(channels, dst);
+    return true;
+}
+}
@@ -0,0 +1,29 @@
+/** Interface file for constant-time median filtering
+ *
+ *  \file ipcv/spatial_filtering/MedianFilter.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/** Median filter an image over a square window
+ *
+ *  Each channel is filtered with a sliding-window histogram (see
+ *  SlidingHistogram), so the cost per pixel does not depend on the window
+ *  radius.  Border pixels are replicated.
+ *
+ *  \param[in] src     source cv::Mat of CV_8UC1 or CV_8UC3
+ *  \param[out] dst    destination cv::Mat of the same type as src
+ *  \param[in] radius  window radius, the window is (2 * radius + 1) pixels
+ *                     square [0, 127]
+ *
+ *  \return            a boolean indicating that the filtering has been
+ *                     carried out without error
+ */
+bool MedianFilter(const cv::Mat& src, cv::Mat& dst, const int radius);
+}
@@ -1,24 +1,173 @@
-/** Implementation file for applying a 3-channel LUT
- *  
- *  \file imgs/ipcv/utils/ApplyLut.spp
+/** Implementation file for applying a LUT
+ *
+ *  \file imgs/ipcv/utils/ApplyLut.cpp
  *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
  *  \date 3 Sep 2018
  */
 
 #include "ApplyLut.h"
 
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
 namespace ipcv {
 
+namespace {
+
+// Look up n consecutive 8-bit values through a single 256-entry table
+void Lookup8(const uint8_t* src, uint8_t* dst, const int n,
+             const uint8_t* table) {
+  int i = 0;
+#if defined(__AVX2__)
+  // The table is split into 16 chunks of 16 entries, each broadcast to both
+  // 128-bit lanes.  For chunk k, (x - 16 k) +sat 0x70 keeps the low nibble
+  // of x and has its high bit clear only when x lies in the chunk, so the
+  // byte shuffle returns the entry for those lanes and zero elsewhere.  Two
+  // vectors are processed per iteration to hide the shuffle latency.
+  __m256i chunks[16];
+  for (int k = 0; k < 16; k++) {
+    chunks[k] = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table + 16 * k)));
+  }
+  const __m256i offset = _mm256_set1_epi8(0x70);
+  const __m256i sixteen = _mm256_set1_epi8(16);
+  for (; i + 64 <= n; i += 64) {
+    __m256i x0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i x1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    __m256i y0 = _mm256_setzero_si256();
+    __m256i y1 = _mm256_setzero_si256();
+    for (int k = 0; k < 16; k++) {
+      y0 = _mm256_or_si256(
+          y0, _mm256_shuffle_epi8(chunks[k], _mm256_adds_epu8(x0, offset)));
+      y1 = _mm256_or_si256(
+          y1, _mm256_shuffle_epi8(chunks[k], _mm256_adds_epu8(x1, offset)));
+      x0 = _mm256_sub_epi8(x0, sixteen);
+      x1 = _mm256_sub_epi8(x1, sixteen);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), y0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), y1);
+  }
+#endif
+  for (; i < n; i++) {
+    dst[i] = table[src[i]];
+  }
+}
+
+// Look up n consecutive 16-bit values through a single 65536-entry table,
+// the table must be followed by one padding entry (the gathers load 32
+// bits per entry)
+void Lookup16(const uint16_t* src, uint16_t* dst, const int n,
+              const uint16_t* table) {
+  int i = 0;
+#if defined(__AVX2__)
+  const int* base = reinterpret_cast<const int*>(table);
+  const __m256i mask = _mm256_set1_epi32(0xFFFF);
+  for (; i + 16 <= n; i += 16) {
+    __m256i x0 = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    __m256i x1 = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8)));
+    __m256i y0 = _mm256_and_si256(_mm256_i32gather_epi32(base, x0, 2), mask);
+    __m256i y1 = _mm256_and_si256(_mm256_i32gather_epi32(base, x1, 2), mask);
+    // packus interleaves the 128-bit lanes, restore the pixel order
+    __m256i y = _mm256_permute4x64_epi64(_mm256_packus_epi32(y0, y1), 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), y);
+  }
+#endif
+  for (; i < n; i++) {
+    dst[i] = table[src[i]];
+  }
+}
+
+// Per-channel tables applied to an interleaved row
+template <typename T>
+void LookupChannels(const T* src, T* dst, const int cols, const int channels,
+                    const vector<const T*>& tables) {
+  for (int c = 0; c < cols; c++) {
+    for (int b = 0; b < channels; b++) {
+      dst[b] = tables[b][src[b]];
+    }
+    src += channels;
+    dst += channels;
+  }
+}
+
+// True when every row of the LUT holds the same table
+bool SharedTable(const cv::Mat& lut) {
+  size_t bytes = lut.cols * lut.elemSize();
+  for (int b = 1; b < lut.rows; b++) {
+    if (memcmp(lut.ptr(0), lut.ptr(b), bytes) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void Apply(const cv::Mat& src, const cv::Mat& lut, cv::Mat& dst) {
+  const int channels = src.channels();
+  const int bins = lut.cols;
+  const bool shared = SharedTable(lut);
+
+  // Copy the tables with a padding entry so the 16-bit gathers never read
+  // past the end of a table
+  vector<T> tables((bins + 1) * lut.rows, 0);
+  vector<const T*> rows(channels);
+  for (int b = 0; b < lut.rows; b++) {
+    memcpy(&tables[b * (bins + 1)], lut.ptr<T>(b), bins * sizeof(T));
+  }
+  for (int b = 0; b < channels; b++) {
+    rows[b] = &tables[(lut.rows == 1 ? 0 : b) * (bins + 1)];
+  }
+
+  cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+    for (int r = range.start; r < range.end; r++) {
+      const T* p = src.ptr<T>(r);
+      T* q = dst.ptr<T>(r);
+      if (shared || channels == 1) {
+        if (sizeof(T) == 1) {
+          Lookup8(reinterpret_cast<const uint8_t*>(p),
+                  reinterpret_cast<uint8_t*>(q), src.cols * channels,
+                  reinterpret_cast<const uint8_t*>(rows[0]));
+        } else {
+          Lookup16(reinterpret_cast<const uint16_t*>(p),
+                   reinterpret_cast<uint16_t*>(q), src.cols * channels,
+                   reinterpret_cast<const uint16_t*>(rows[0]));
+        }
+      } else {
+        LookupChannels(p, q, src.cols, channels, rows);
+      }
+    }
+  });
+}
+}
+
 void ApplyLut(const cv::Mat& src, const cv::Mat &lut, cv::Mat& dst) {
+  int depth = src.depth();
+  int bins = depth == CV_8U ? 256 : 65536;
+  if ((depth != CV_8U && depth != CV_16U) || lut.depth() != depth ||
+      lut.channels() != 1 || lut.cols != bins ||
+      (lut.rows != 1 && lut.rows != src.channels())) {
+    cerr << "Unsupported source image or LUT for LUT application" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The LUT may be applied in place, the output only depends on the source
+  // pixel at the same location
   dst.create(src.size(), src.type());
-  for (int r = 0; r < src.rows; r++) {
-    for (int c = 0; c < src.cols; c++) {
-      const auto& src_dc = src.at<cv::Vec3b>(r, c);
-      auto& dst_dc = dst.at<cv::Vec3b>(r, c);
-      dst_dc[0] = lut.at<uint8_t>(0, src_dc[0]);
-      dst_dc[1] = lut.at<uint8_t>(1, src_dc[1]);
-      dst_dc[2] = lut.at<uint8_t>(2, src_dc[2]);
-    }
+  if (depth == CV_8U) {
+    Apply<uint8_t>(src, lut, dst);
+  } else {
+    Apply<uint16_t>(src, lut, dst);
   }
 }
 }
@@ -1,6 +1,6 @@
-/** Interface file for applying a 3-channel LUT
+/** Interface file for applying a LUT
  *
- *  \file ipcv/utils/Histogram.h
+ *  \file ipcv/utils/ApplyLut.h
  *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
  *  \date 3 Sep 2018
  */
@@ -11,11 +11,19 @@
 
 namespace ipcv {
 
-/** Implementation file for applying a 3-channel LUT
- *  
- *  \param[in] src   source cv::Mat of CV_8UC3
- *  \param[in] lut   the look up table (cv:Mat) to apply to the source image
- *  \param[out] dst  destination cv:Mat of CV_8UC3
+/** Apply a LUT to every channel of a source image
+ *
+ *  8-bit tables are applied 32 pixels at a time with byte shuffles when
+ *  AVX2 is available, and 16-bit tables with gathers (scalar fallbacks are
+ *  used otherwise, and for tables that differ between channels of
+ *  interleaved images).
+ *
+ *  \param[in] src   source cv::Mat of CV_8UC(n) or CV_16UC(n)
+ *  \param[in] lut   the look up table (cv:Mat) to apply to the source image,
+ *                   of the same depth as src, with either one row per
+ *                   channel or a single row shared by all channels, and
+ *                   256 (8-bit) or 65536 (16-bit) columns
+ *  \param[out] dst  destination cv:Mat of the same type as src
  */
 void ApplyLut(const cv::Mat& src, const cv::Mat &lut, cv::Mat& dst);
 }
@@ -5,248 +5,821 @@
  *  \date 04 Jan 2019
  */
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <opencv2/imgproc.hpp>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "DeltaE.h"
 
+#include "imgs/ipcv/utils/LabLut.h"
+
 using namespace std;
 
 namespace ipcv {
 
-double DeltaE(const cv::Mat& src1, const cv::Mat& src2, cv::Mat& dE,
-              int max_value, int standard, string application) {
-  if ((src1.rows != src2.rows) || (src1.cols != src2.cols) ||
-      (src1.channels() != src2.channels())) {
-    cerr << "Image dimensions must match exactly for PSNR computation" << endl;
-    exit(EXIT_FAILURE);
+namespace {
+
+// The vectorized CIEDE2000 evaluates the formula in single precision with
+// polynomial approximations of atan2, sin/cos and exp (Cephes minimax
+// coefficients, each accurate to a few float ulps over its reduced range).
+// The cosine terms of T are expanded from a single sin/cos of the mean hue
+// with multiple-angle identities.  The resulting delta E stays within 1e-3
+// of the double precision reference (DeltaE2000, about 5e-5 on random
+// 8-bit color pairs) except at the discontinuity of the formula itself,
+// where the hue difference of the two colors is 180 degrees and rounding
+// may select the other branch of the mean hue.
+const float kPi = 3.14159265358979f;
+const float kDegrees = 180.f / kPi;
+const float kRadians = kPi / 180.f;
+const float kTwentyFiveToTheSeventh = 6103515625.f;
+const float kChromaTolerance = 1.0e-15f;
+
+// atan(x) for x in [0, 1] (reduced to |x| <= tan(pi / 8))
+float AtanUnit(float x) {
+  float offset = 0;
+  if (x > 0.414213562f) {
+    offset = kPi / 4;
+    x = (x - 1) / (x + 1);
   }
+  float z = x * x;
+  return offset + (((8.05374449538e-2f * z - 1.38776856032e-1f) * z +
+                    1.99777106478e-1f) * z - 3.33329491539e-1f) * z * x + x;
+}
 
-  if (src1.channels() != 3) {
-    cerr << "Images must be 3-channel for delta E computation" << endl;
-    exit(EXIT_FAILURE);
+// atan2(y, x) in degrees [0, 360]
+float Atan2Degrees(const float y, const float x) {
+  float ax = fabs(x);
+  float ay = fabs(y);
+  float high = max(ax, ay);
+  float t = AtanUnit(high > 0 ? min(ax, ay) / high : 0);
+  if (ay > ax) {
+    t = kPi / 2 - t;
   }
+  if (x < 0) {
+    t = kPi - t;
+  }
+  if (y < 0) {
+    t = 2 * kPi - t;
+  }
+  return t * kDegrees;
+}
 
-  cv::Mat src1_normalized;
-  src1.convertTo(src1_normalized, CV_32F, 1.0 / static_cast<float>(max_value));
-  cv::Mat src2_normalized;
-  src2.convertTo(src2_normalized, CV_32F, 1.0 / static_cast<float>(max_value));
-
-  cv::Mat lab1;
-  cv::cvtColor(src1_normalized, lab1, cv::COLOR_BGR2Lab);
-  cv::Mat lab2;
-  cv::cvtColor(src2_normalized, lab2, cv::COLOR_BGR2Lab);
+// sin and cos of an angle in degrees (reduced to [-45, 45] degrees)
+void SinCosDegrees(const float degrees, float& s, float& c) {
+  float n = floor(degrees / 90 + 0.5f);
+  float r = (degrees - 90 * n) * kRadians;
+  float z = r * r;
+  float sr = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z -
+              1.6666654611e-1f) * z * r + r;
+  float cr = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z +
+              4.166664568298827e-2f) * z * z - 0.5f * z + 1;
+  switch (static_cast<int>(n) & 3) {
+    case 0:
+      s = sr;
+      c = cr;
+      break;
+    case 1:
+      s = cr;
+      c = -sr;
+      break;
+    case 2:
+      s = -sr;
+      c = -cr;
+      break;
+    default:
+      s = -cr;
+      c = sr;
+      break;
+  }
+}
 
-  double deltae;
+// exp(v) for v <= 0 (values below -87 underflow to 0)
+float ExpNegative(const float v) {
+  if (v < -87.f) {
+    return 0;
+  }
+  float n = floor(v * 1.44269504089f + 0.5f);
+  float r = v - n * 0.693359375f + n * 2.12194440e-4f;
+  float p = (((((1.9875691500e-4f * r + 1.3981999507e-3f) * r +
+                8.3334519073e-3f) * r + 4.1665795894e-2f) * r +
+              1.6666665459e-1f) * r + 5.0000001201e-1f) * r * r + r + 1;
+  return ldexp(p, static_cast<int>(n));
+}
 
-  switch (standard) {
-    case 1976: {
-      // Compute squared differences between L*a*b* for the two source images
-      cv::Mat se;
-      cv::subtract(lab1, lab2, se);
-      cv::multiply(se, se, se); 
-  
-      // Split into separate L*, a*, and b* squared difference channels
-      cv::Mat channels_se[3];
-      cv::split(se, channels_se);
-  
-      // Compute delta E
-      dE = channels_se[0] + channels_se[1] + channels_se[2];
-      cv::sqrt(dE, dE);
-      break;
+// Single precision CIEDE2000 of one pair of L*a*b* colors
+float FastDeltaE2000(const float* lab1, const float* lab2) {
+  float Lbar = (lab1[0] + lab2[0]) / 2;
+  float deltaLprimed = lab2[0] - lab1[0];
+
+  float Cstar1 = sqrt(lab1[1] * lab1[1] + lab1[2] * lab1[2]);
+  float Cstar2 = sqrt(lab2[1] * lab2[1] + lab2[2] * lab2[2]);
+  float Cbar = (Cstar1 + Cstar2) / 2;
+  float Cbar7 = Cbar * Cbar * Cbar;
+  Cbar7 = Cbar7 * Cbar7 * Cbar;
+  float G = 1.5f - 0.5f * sqrt(Cbar7 / (Cbar7 + kTwentyFiveToTheSeventh));
+
+  float aprimed1 = lab1[1] * G;
+  float aprimed2 = lab2[1] * G;
+  float Cprimed1 = sqrt(aprimed1 * aprimed1 + lab1[2] * lab1[2]);
+  float Cprimed2 = sqrt(aprimed2 * aprimed2 + lab2[2] * lab2[2]);
+  float deltaCprimed = Cprimed2 - Cprimed1;
+  float Cbarprimed = (Cprimed1 + Cprimed2) / 2;
+
+  float hprimed1 = Cprimed1 < kChromaTolerance
+                       ? 0 : Atan2Degrees(lab1[2], aprimed1);
+  float hprimed2 = Cprimed2 < kChromaTolerance
+                       ? 0 : Atan2Degrees(lab2[2], aprimed2);
+
+  float deltahprimed = 0;
+  float Hbarprimed = hprimed1 + hprimed2;
+  if (Cprimed1 >= kChromaTolerance && Cprimed2 >= kChromaTolerance) {
+    deltahprimed = hprimed2 - hprimed1;
+    if (deltahprimed > 180) {
+      deltahprimed -= 360;
+    } else if (deltahprimed < -180) {
+      deltahprimed += 360;
+    }
+    if (fabs(hprimed1 - hprimed2) > 180) {
+      Hbarprimed += Hbarprimed < 360 ? 360 : -360;
     }
+    Hbarprimed /= 2;
+  }
 
-    case 1994: {
-      dE.create(src1.rows, src1.cols, CV_32F);
+  float s;
+  float c;
+  SinCosDegrees(deltahprimed / 2, s, c);
+  float deltaHprimed = 2 * sqrt(Cprimed1 * Cprimed2) * s;
+
+  // T from cos/sin of multiples of the mean hue
+  SinCosDegrees(Hbarprimed, s, c);
+  float c2 = 2 * c * c - 1;
+  float s2 = 2 * s * c;
+  float c3 = c * (4 * c * c - 3);
+  float s3 = s * (3 - 4 * s * s);
+  float c4 = 2 * c2 * c2 - 1;
+  float s4 = 2 * s2 * c2;
+  float T = 1 - 0.17f * (c * 0.866025404f + s * 0.5f) +
+            0.24f * c2 +
+            0.32f * (c3 * 0.994521895f - s3 * 0.104528463f) -
+            0.20f * (c4 * 0.453990500f + s4 * 0.891006524f);
+
+  float L50 = (Lbar - 50) * (Lbar - 50);
+  float SL = 1 + 0.015f * L50 / sqrt(20 + L50);
+  float SC = 1 + 0.045f * Cbarprimed;
+  float SH = 1 + 0.015f * Cbarprimed * T;
+
+  float Cbarprimed7 = Cbarprimed * Cbarprimed * Cbarprimed;
+  Cbarprimed7 = Cbarprimed7 * Cbarprimed7 * Cbarprimed;
+  float x = (Hbarprimed - 275) / 25;
+  SinCosDegrees(60 * ExpNegative(-x * x), s, c);
+  float RT =
+      -2 * sqrt(Cbarprimed7 / (Cbarprimed7 + kTwentyFiveToTheSeventh)) * s;
+
+  float dL = deltaLprimed / SL;
+  float dC = deltaCprimed / SC;
+  float dH = deltaHprimed / SH;
+  return sqrt(max(dL * dL + dC * dC + dH * dH + RT * dC * dH, 0.f));
+}
 
-      double kL;
-      double K1;
-      double K2;
-      if (application == "graphic_arts") {
-        kL = 1.0;
-        K1 = 0.045;
-        K2 = 0.015;
-      } else if (application == "textiles") {
-        kL = 2.0;
-        K1 = 0.048;
-        K2 = 0.014;
-      } else {
-        cerr << "Specified application for delta E 1994 not supported: "
-             << application << endl;
-        exit(EXIT_FAILURE);
-      }
-      double kC = 1.0;
-      double kH = 1.0;
+#if defined(__AVX2__)
+// Single precision operations on 8 lanes
+struct Avx2Ops {
+  using Vector = __m256;
+  static const int width = 8;
+
+  static Vector Load(const float* p) { return _mm256_loadu_ps(p); }
+  static void Store(float* p, const Vector v) { _mm256_storeu_ps(p, v); }
+  static Vector Set(const float v) { return _mm256_set1_ps(v); }
+  static Vector Add(const Vector a, const Vector b) {
+    return _mm256_add_ps(a, b);
+  }
+  static Vector Sub(const Vector a, const Vector b) {
+    return _mm256_sub_ps(a, b);
+  }
+  static Vector Mul(const Vector a, const Vector b) {
+    return _mm256_mul_ps(a, b);
+  }
+  static Vector Div(const Vector a, const Vector b) {
+    return _mm256_div_ps(a, b);
+  }
+  static Vector Min(const Vector a, const Vector b) {
+    return _mm256_min_ps(a, b);
+  }
+  static Vector Max(const Vector a, const Vector b) {
+    return _mm256_max_ps(a, b);
+  }
+  static Vector Sqrt(const Vector a) { return _mm256_sqrt_ps(a); }
+  static Vector And(const Vector a, const Vector b) {
+    return _mm256_and_ps(a, b);
+  }
+  static Vector AndNot(const Vector a, const Vector b) {
+    return _mm256_andnot_ps(a, b);
+  }
+  static Vector Xor(const Vector a, const Vector b) {
+    return _mm256_xor_ps(a, b);
+  }
+  static Vector Greater(const Vector a, const Vector b) {
+    return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+  }
+  static Vector Less(const Vector a, const Vector b) {
+    return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+  }
+  static Vector GreaterEqual(const Vector a, const Vector b) {
+    return _mm256_cmp_ps(a, b, _CMP_GE_OQ);
+  }
+  // mask ? a : b
+  static Vector Select(const Vector mask, const Vector a, const Vector b) {
+    return _mm256_blendv_ps(b, a, mask);
+  }
+  static Vector Floor(const Vector a) { return _mm256_floor_ps(a); }
+
+  // Masks of the quadrants n (integral values): odd quadrants, quadrants 2
+  // and 3 and quadrants 1 and 2 (the last two as sign bits only)
+  static void Quadrant(const Vector n, Vector& odd, Vector& sin_sign,
+                       Vector& cos_sign) {
+    __m256i q = _mm256_cvtps_epi32(n);
+    odd = _mm256_castsi256_ps(_mm256_srai_epi32(_mm256_slli_epi32(q, 31), 31));
+    sin_sign = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_srli_epi32(q, 1), 31));
+    cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_xor_si256(q, _mm256_srli_epi32(q, 1)), 31));
+  }
+
+  // 2^n of integral n in [-126, 127] through the exponent bits
+  static Vector Pow2(const Vector n) {
+    return _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23));
+  }
+};
+#endif
+
+#if defined(__SSE2__)
+// Single precision operations on 4 lanes
+struct Sse2Ops {
+  using Vector = __m128;
+  static const int width = 4;
+
+  static Vector Load(const float* p) { return _mm_loadu_ps(p); }
+  static void Store(float* p, const Vector v) { _mm_storeu_ps(p, v); }
+  static Vector Set(const float v) { return _mm_set1_ps(v); }
+  static Vector Add(const Vector a, const Vector b) { return _mm_add_ps(a, b); }
+  static Vector Sub(const Vector a, const Vector b) { return _mm_sub_ps(a, b); }
+  static Vector Mul(const Vector a, const Vector b) { return _mm_mul_ps(a, b); }
+  static Vector Div(const Vector a, const Vector b) { return _mm_div_ps(a, b); }
+  static Vector Min(const Vector a, const Vector b) { return _mm_min_ps(a, b); }
+  static Vector Max(const Vector a, const Vector b) { return _mm_max_ps(a, b); }
+  static Vector Sqrt(const Vector a) { return _mm_sqrt_ps(a); }
+  static Vector And(const Vector a, const Vector b) { return _mm_and_ps(a, b); }
+  static Vector AndNot(const Vector a, const Vector b) {
+    return _mm_andnot_ps(a, b);
+  }
+  static Vector Xor(const Vector a, const Vector b) { return _mm_xor_ps(a, b); }
+  static Vector Greater(const Vector a, const Vector b) {
+    return _mm_cmpgt_ps(a, b);
+  }
+  static Vector Less(const Vector a, const Vector b) {
+    return _mm_cmplt_ps(a, b);
+  }
+  static Vector GreaterEqual(const Vector a, const Vector b) {
+    return _mm_cmpge_ps(a, b);
+  }
+  // mask ? a : b (no blend before SSE4.1)
+  static Vector Select(const Vector mask, const Vector a, const Vector b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+  }
+  // Truncation corrected towards negative infinity (no round before
+  // SSE4.1), the arguments here are far below 2^31 in magnitude
+  static Vector Floor(const Vector a) {
+    Vector t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.f)));
+  }
 
-      for (int r = 0; r < dE.rows; r++) {
-        for (int c = 0; c < dE.cols; c++) {
-          const auto& lab1_value = lab1.at<cv::Vec3f>(r, c);
-          const auto& lab2_value = lab2.at<cv::Vec3f>(r, c);
-          auto& dE_value = dE.at<float>(r, c);
+  // See Avx2Ops::Quadrant
+  static void Quadrant(const Vector n, Vector& odd, Vector& sin_sign,
+                       Vector& cos_sign) {
+    __m128i q = _mm_cvtps_epi32(n);
+    odd = _mm_castsi128_ps(_mm_srai_epi32(_mm_slli_epi32(q, 31), 31));
+    sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_srli_epi32(q, 1), 31));
+    cos_sign = _mm_castsi128_ps(
+        _mm_slli_epi32(_mm_xor_si128(q, _mm_srli_epi32(q, 1)), 31));
+  }
 
-          double Lstar1 = lab1_value[0];
-          double astar1 = lab1_value[1];
-          double bstar1 = lab1_value[2];
+  // See Avx2Ops::Pow2
+  static Vector Pow2(const Vector n) {
+    return _mm_castsi128_ps(_mm_slli_epi32(
+        _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127)), 23));
+  }
+};
+#endif
+
+// Vector counterparts of the approximations above, written once for the
+// lane operations of an instruction set (Avx2Ops or Sse2Ops)
+template <typename Ops>
+typename Ops::Vector AtanUnitN(typename Ops::Vector x) {
+  using V = typename Ops::Vector;
+  const V one = Ops::Set(1.f);
+  V reduce = Ops::Greater(x, Ops::Set(0.414213562f));
+  V offset = Ops::And(reduce, Ops::Set(kPi / 4));
+  x = Ops::Select(reduce, Ops::Div(Ops::Sub(x, one), Ops::Add(x, one)), x);
+  V z = Ops::Mul(x, x);
+  V p = Ops::Set(8.05374449538e-2f);
+  p = Ops::Sub(Ops::Mul(p, z), Ops::Set(1.38776856032e-1f));
+  p = Ops::Add(Ops::Mul(p, z), Ops::Set(1.99777106478e-1f));
+  p = Ops::Sub(Ops::Mul(p, z), Ops::Set(3.33329491539e-1f));
+  p = Ops::Add(Ops::Mul(Ops::Mul(p, z), x), x);
+  return Ops::Add(offset, p);
+}
 
-          double Lstar2 = lab2_value[0];
-          double astar2 = lab2_value[1];
-          double bstar2 = lab2_value[2];
+template <typename Ops>
+typename Ops::Vector AbsN(const typename Ops::Vector x) {
+  return Ops::AndNot(Ops::Set(-0.f), x);
+}
 
-          double deltaLstar = Lstar1 - Lstar2;
+template <typename Ops>
+typename Ops::Vector Atan2DegreesN(const typename Ops::Vector y,
+                                   const typename Ops::Vector x) {
+  using V = typename Ops::Vector;
+  const V zero = Ops::Set(0.f);
+  V ax = AbsN<Ops>(x);
+  V ay = AbsN<Ops>(y);
+  V high = Ops::Max(ax, ay);
+  V ratio = Ops::And(Ops::Div(Ops::Min(ax, ay), high),
+                     Ops::Greater(high, zero));
+  V t = AtanUnitN<Ops>(ratio);
+  t = Ops::Select(Ops::Greater(ay, ax), Ops::Sub(Ops::Set(kPi / 2), t), t);
+  t = Ops::Select(Ops::Less(x, zero), Ops::Sub(Ops::Set(kPi), t), t);
+  t = Ops::Select(Ops::Less(y, zero), Ops::Sub(Ops::Set(2 * kPi), t), t);
+  return Ops::Mul(t, Ops::Set(kDegrees));
+}
 
-          double Cstar1 = sqrt(pow(astar1, 2.0) + pow(bstar1, 2.0));
-          double Cstar2 = sqrt(pow(astar2, 2.0) + pow(bstar2, 2.0));
-          double deltaCstarab = Cstar1 - Cstar2;
+template <typename Ops>
+void SinCosDegreesN(const typename Ops::Vector degrees,
+                    typename Ops::Vector& s, typename Ops::Vector& c) {
+  using V = typename Ops::Vector;
+  V n = Ops::Floor(
+      Ops::Add(Ops::Mul(degrees, Ops::Set(1.f / 90)), Ops::Set(0.5f)));
+  V r = Ops::Mul(Ops::Sub(degrees, Ops::Mul(n, Ops::Set(90.f))),
+                 Ops::Set(kRadians));
+  V z = Ops::Mul(r, r);
+  V sr = Ops::Set(-1.9515295891e-4f);
+  sr = Ops::Add(Ops::Mul(sr, z), Ops::Set(8.3321608736e-3f));
+  sr = Ops::Sub(Ops::Mul(sr, z), Ops::Set(1.6666654611e-1f));
+  sr = Ops::Add(Ops::Mul(Ops::Mul(sr, z), r), r);
+  V cr = Ops::Set(2.443315711809948e-5f);
+  cr = Ops::Sub(Ops::Mul(cr, z), Ops::Set(1.388731625493765e-3f));
+  cr = Ops::Add(Ops::Mul(cr, z), Ops::Set(4.166664568298827e-2f));
+  cr = Ops::Add(Ops::Sub(Ops::Mul(Ops::Mul(cr, z), z),
+                         Ops::Mul(Ops::Set(0.5f), z)),
+                Ops::Set(1.f));
+
+  // Quadrant n mod 4: odd quadrants swap sin and cos, quadrants 1 and 2
+  // negate cos, quadrants 2 and 3 negate sin
+  V odd;
+  V sin_sign;
+  V cos_sign;
+  Ops::Quadrant(n, odd, sin_sign, cos_sign);
+  s = Ops::Xor(Ops::Select(odd, cr, sr), sin_sign);
+  c = Ops::Xor(Ops::Select(odd, sr, cr), cos_sign);
+}
 
-          double deltaastar = astar1 - astar2;
-          double deltabstar = bstar1 - bstar2;
+template <typename Ops>
+typename Ops::Vector ExpNegativeN(typename Ops::Vector v) {
+  using V = typename Ops::Vector;
+  V underflow = Ops::Less(v, Ops::Set(-87.f));
+  v = Ops::Max(v, Ops::Set(-87.f));
+  V n = Ops::Floor(
+      Ops::Add(Ops::Mul(v, Ops::Set(1.44269504089f)), Ops::Set(0.5f)));
+  V r = Ops::Add(Ops::Sub(v, Ops::Mul(n, Ops::Set(0.693359375f))),
+                 Ops::Mul(n, Ops::Set(2.12194440e-4f)));
+  V p = Ops::Set(1.9875691500e-4f);
+  p = Ops::Add(Ops::Mul(p, r), Ops::Set(1.3981999507e-3f));
+  p = Ops::Add(Ops::Mul(p, r), Ops::Set(8.3334519073e-3f));
+  p = Ops::Add(Ops::Mul(p, r), Ops::Set(4.1665795894e-2f));
+  p = Ops::Add(Ops::Mul(p, r), Ops::Set(1.6666665459e-1f));
+  p = Ops::Add(Ops::Mul(p, r), Ops::Set(5.0000001201e-1f));
+  p = Ops::Add(Ops::Add(Ops::Mul(Ops::Mul(p, r), r), r), Ops::Set(1.f));
+  p = Ops::Mul(p, Ops::Pow2(n));
+  return Ops::AndNot(underflow, p);
+}
 
-          double deltaHstarab = sqrt(pow(deltaastar, 2.0) + 
-                                     pow(deltabstar, 2.0) - 
-                                     pow(deltaCstarab, 2.0));
+template <typename Ops>
+typename Ops::Vector Pow7N(const typename Ops::Vector x) {
+  typename Ops::Vector x3 = Ops::Mul(Ops::Mul(x, x), x);
+  return Ops::Mul(Ops::Mul(x3, x3), x);
+}
 
-          double SL = 1.0;
-          double SC = 1.0 + K1 * Cstar1;
-          double SH = 1.0 + K2 * Cstar1;
+// CIEDE2000 of Ops::width pairs of L*a*b* colors (planar)
+template <typename Ops>
+typename Ops::Vector FastDeltaE2000N(const float* L1, const float* a1,
+                                     const float* b1, const float* L2,
+                                     const float* a2, const float* b2) {
+  using V = typename Ops::Vector;
+  const V zero = Ops::Set(0.f);
+  const V one = Ops::Set(1.f);
+  const V half = Ops::Set(0.5f);
+  const V k180 = Ops::Set(180.f);
+  const V k360 = Ops::Set(360.f);
+  const V k25_7 = Ops::Set(kTwentyFiveToTheSeventh);
+  const V tolerance = Ops::Set(kChromaTolerance);
+
+  V Lstar1 = Ops::Load(L1);
+  V astar1 = Ops::Load(a1);
+  V bstar1 = Ops::Load(b1);
+  V Lstar2 = Ops::Load(L2);
+  V astar2 = Ops::Load(a2);
+  V bstar2 = Ops::Load(b2);
+
+  V Lbar = Ops::Mul(Ops::Add(Lstar1, Lstar2), half);
+  V deltaLprimed = Ops::Sub(Lstar2, Lstar1);
+
+  V Cstar1 = Ops::Sqrt(
+      Ops::Add(Ops::Mul(astar1, astar1), Ops::Mul(bstar1, bstar1)));
+  V Cstar2 = Ops::Sqrt(
+      Ops::Add(Ops::Mul(astar2, astar2), Ops::Mul(bstar2, bstar2)));
+  V Cbar7 = Pow7N<Ops>(Ops::Mul(Ops::Add(Cstar1, Cstar2), half));
+  V G = Ops::Sub(Ops::Set(1.5f),
+                 Ops::Mul(half, Ops::Sqrt(Ops::Div(
+                                    Cbar7, Ops::Add(Cbar7, k25_7)))));
+
+  V aprimed1 = Ops::Mul(astar1, G);
+  V aprimed2 = Ops::Mul(astar2, G);
+  V Cprimed1 = Ops::Sqrt(
+      Ops::Add(Ops::Mul(aprimed1, aprimed1), Ops::Mul(bstar1, bstar1)));
+  V Cprimed2 = Ops::Sqrt(
+      Ops::Add(Ops::Mul(aprimed2, aprimed2), Ops::Mul(bstar2, bstar2)));
+  V deltaCprimed = Ops::Sub(Cprimed2, Cprimed1);
+  V Cbarprimed = Ops::Mul(Ops::Add(Cprimed1, Cprimed2), half);
+
+  V chromatic1 = Ops::GreaterEqual(Cprimed1, tolerance);
+  V chromatic2 = Ops::GreaterEqual(Cprimed2, tolerance);
+  V chromatic = Ops::And(chromatic1, chromatic2);
+  V hprimed1 = Ops::And(Atan2DegreesN<Ops>(bstar1, aprimed1), chromatic1);
+  V hprimed2 = Ops::And(Atan2DegreesN<Ops>(bstar2, aprimed2), chromatic2);
+
+  V deltahprimed = Ops::Sub(hprimed2, hprimed1);
+  deltahprimed = Ops::Sub(
+      deltahprimed, Ops::And(Ops::Greater(deltahprimed, k180), k360));
+  deltahprimed = Ops::Add(
+      deltahprimed,
+      Ops::And(Ops::Less(deltahprimed, Ops::Set(-180.f)), k360));
+  deltahprimed = Ops::And(deltahprimed, chromatic);
+
+  V sum = Ops::Add(hprimed1, hprimed2);
+  V apart = Ops::Greater(AbsN<Ops>(Ops::Sub(hprimed1, hprimed2)), k180);
+  V shift = Ops::Select(Ops::Less(sum, k360), k360, Ops::Set(-360.f));
+  V mean = Ops::Mul(Ops::Add(sum, Ops::And(shift, apart)), half);
+  V Hbarprimed = Ops::Select(chromatic, mean, sum);
+
+  V s;
+  V c;
+  SinCosDegreesN<Ops>(Ops::Mul(deltahprimed, half), s, c);
+  V deltaHprimed = Ops::Mul(
+      Ops::Mul(Ops::Set(2.f), Ops::Sqrt(Ops::Mul(Cprimed1, Cprimed2))), s);
+
+  SinCosDegreesN<Ops>(Hbarprimed, s, c);
+  V c2 = Ops::Sub(Ops::Mul(Ops::Set(2.f), Ops::Mul(c, c)), one);
+  V s2 = Ops::Mul(Ops::Set(2.f), Ops::Mul(s, c));
+  V c3 = Ops::Mul(
+      c, Ops::Sub(Ops::Mul(Ops::Set(4.f), Ops::Mul(c, c)), Ops::Set(3.f)));
+  V s3 = Ops::Mul(
+      s, Ops::Sub(Ops::Set(3.f), Ops::Mul(Ops::Set(4.f), Ops::Mul(s, s))));
+  V c4 = Ops::Sub(Ops::Mul(Ops::Set(2.f), Ops::Mul(c2, c2)), one);
+  V s4 = Ops::Mul(Ops::Set(2.f), Ops::Mul(s2, c2));
+  V T = Ops::Sub(
+      one, Ops::Mul(Ops::Set(0.17f),
+                    Ops::Add(Ops::Mul(c, Ops::Set(0.866025404f)),
+                             Ops::Mul(s, half))));
+  T = Ops::Add(T, Ops::Mul(Ops::Set(0.24f), c2));
+  T = Ops::Add(
+      T, Ops::Mul(Ops::Set(0.32f),
+                  Ops::Sub(Ops::Mul(c3, Ops::Set(0.994521895f)),
+                           Ops::Mul(s3, Ops::Set(0.104528463f)))));
+  T = Ops::Sub(
+      T, Ops::Mul(Ops::Set(0.20f),
+                  Ops::Add(Ops::Mul(c4, Ops::Set(0.453990500f)),
+                           Ops::Mul(s4, Ops::Set(0.891006524f)))));
+
+  V L50 = Ops::Sub(Lbar, Ops::Set(50.f));
+  L50 = Ops::Mul(L50, L50);
+  V SL = Ops::Add(
+      one, Ops::Div(Ops::Mul(Ops::Set(0.015f), L50),
+                    Ops::Sqrt(Ops::Add(Ops::Set(20.f), L50))));
+  V SC = Ops::Add(one, Ops::Mul(Ops::Set(0.045f), Cbarprimed));
+  V SH = Ops::Add(one, Ops::Mul(Ops::Mul(Ops::Set(0.015f), Cbarprimed), T));
+
+  V Cbarprimed7 = Pow7N<Ops>(Cbarprimed);
+  V x = Ops::Mul(Ops::Sub(Hbarprimed, Ops::Set(275.f)), Ops::Set(1.f / 25));
+  SinCosDegreesN<Ops>(
+      Ops::Mul(Ops::Set(60.f), ExpNegativeN<Ops>(Ops::Sub(zero,
+                                                          Ops::Mul(x, x)))),
+      s, c);
+  V RT = Ops::Mul(
+      Ops::Mul(Ops::Set(-2.f),
+               Ops::Sqrt(Ops::Div(Cbarprimed7,
+                                  Ops::Add(Cbarprimed7, k25_7)))),
+      s);
+
+  V dL = Ops::Div(deltaLprimed, SL);
+  V dC = Ops::Div(deltaCprimed, SC);
+  V dH = Ops::Div(deltaHprimed, SH);
+  V squared = Ops::Add(Ops::Add(Ops::Mul(dL, dL), Ops::Mul(dC, dC)),
+                       Ops::Add(Ops::Mul(dH, dH),
+                                Ops::Mul(Ops::Mul(RT, dC), dH)));
+  return Ops::Sqrt(Ops::Max(squared, zero));
+}
 
-          dE_value = sqrt(pow(deltaLstar / kL / SL, 2.0) +
-                          pow(deltaCstarab / kC / SC, 2.0) +
-                          pow(deltaHstarab / kH / SH, 2.0));
-        }
+// CIEDE2000 of the leading multiple of Ops::width pixels of a row of
+// interleaved L*a*b* pixels, returns the number of pixels computed
+template <typename Ops>
+int FastDeltaE2000Vectors(const float* lab1, const float* lab2, float* dE,
+                          const int cols) {
+  const int width = Ops::width;
+  float planes[6][width];
+  int c = 0;
+  for (; c + width <= cols; c += width) {
+    for (int k = 0; k < width; k++) {
+      for (int a = 0; a < 3; a++) {
+        planes[a][k] = lab1[3 * (c + k) + a];
+        planes[3 + a][k] = lab2[3 * (c + k) + a];
       }
-      break;
     }
+    Ops::Store(dE + c,
+               FastDeltaE2000N<Ops>(planes[0], planes[1], planes[2],
+                                    planes[3], planes[4], planes[5]));
+  }
+  return c;
+}
 
-    case 2000: {
-      dE.create(src1.rows, src1.cols, CV_32F);
-
-      double tolerance = 1.0e-15;
-      const double PI = 3.141592653589793238463;
-
-      double kL = 1.0;
-      double kC = 1.0;
-      double kH = 1.0;
-
-      for (int r = 0; r < dE.rows; r++) {
-        for (int c = 0; c < dE.cols; c++) {
-          const auto& lab1_value = lab1.at<cv::Vec3f>(r, c);
-          const auto& lab2_value = lab2.at<cv::Vec3f>(r, c);
-          auto& dE_value = dE.at<float>(r, c);
-
-          double Lstar1 = lab1_value[0];
-          double astar1 = lab1_value[1];
-          double bstar1 = lab1_value[2];
-
-          double Lstar2 = lab2_value[0];
-          double astar2 = lab2_value[1];
-          double bstar2 = lab2_value[2];
-
-          double deltaLprimed = Lstar2 - Lstar1;
-
-          double Lbar = (Lstar1 + Lstar2) / 2.0;
-
-          double Cstar1 = sqrt(pow(astar1, 2.0) + pow(bstar1, 2.0));
-          double Cstar2 = sqrt(pow(astar2, 2.0) + pow(bstar2, 2.0));
-          double Cbar = (Cstar1 + Cstar2) / 2.0;
-
-          double aprimed1 = astar1 + astar1 / 2.0 * 
-              (1 - sqrt(pow(Cbar, 7.0) / (pow(Cbar, 7.0) + 6103515625)));
-          double aprimed2 = astar2 + astar2 / 2.0 * 
-              (1 - sqrt(pow(Cbar, 7.0) / (pow(Cbar, 7.0) + 6103515625)));
-
-          double Cprimed1 = sqrt(aprimed1 * aprimed1 + bstar1 * bstar1);
-          double Cprimed2 = sqrt(aprimed2 * aprimed2 + bstar2 * bstar2);
-          double deltaCprimed = Cprimed2 - Cprimed1;
-          double Cbarprimed = (Cprimed1 + Cprimed2) / 2.0;
-
-          double hprimed1;
-          if ((abs(bstar1) < tolerance) && (abs(aprimed1) < tolerance)) {
-            hprimed1 = 0;
-          } else {
-            hprimed1 = atan2(bstar1, aprimed1) * 180 / PI;
-            if (hprimed1 < 0) {
-              hprimed1 += 360;
-            }
-          }
-          double hprimed2;
-          if ((abs(bstar2) < tolerance) && (abs(aprimed2) < tolerance)) {
-            hprimed2 = 0;
-          } else {
-            hprimed2 = atan2(bstar2, aprimed2) * 180 / PI;
-            if (hprimed2 < 0) {
-              hprimed2 += 360;
-            }
-          }
-
-          double deltahprimed;
-          if ((abs(Cprimed1) < tolerance) || (abs(Cprimed2) < tolerance)) {
-            deltahprimed = 0;
-          } else {
-            double temp = abs(hprimed1 - hprimed2);
-            if (temp <= 180) {
-              deltahprimed = hprimed2 - hprimed1;
-            } else if ((temp > 180) && (hprimed2 <= hprimed1)) {
-              deltahprimed = hprimed2 - hprimed1 + 360;
-            } else if ((temp > 180) && (hprimed2 > hprimed1)) {
-              deltahprimed = hprimed2 - hprimed1 - 360;
-            }
-          }
-
-          double Hbarprimed;
-          if ((abs(Cprimed1) < tolerance) || (abs(Cprimed2) < tolerance)) {
-            Hbarprimed = hprimed1 + hprimed2;
-          } else {
-            double temp = abs(hprimed1 - hprimed2);
-            if (temp <= 180) {
-              Hbarprimed = (hprimed1 + hprimed2) / 2.0;
-            } else if ((temp > 180) && ((hprimed1 + hprimed2) < 360)) {
-              Hbarprimed = (hprimed1 + hprimed2 + 360) / 2.0;
-            } else if ((temp > 180) && ((hprimed1 + hprimed2) >= 360)) {
-              Hbarprimed = (hprimed1 + hprimed2 - 360) / 2.0;
-            }
-          }
-
-          double deltaHprimed = 2 * sqrt(Cprimed1 * Cprimed2) * 
-                                sin((deltahprimed / 2) * PI / 180.0);
-
-          double T = 1 - 0.17 * cos((Hbarprimed - 30) * PI / 180.0) +
-                         0.24 * cos((2 * Hbarprimed) * PI / 180.0) +
-                         0.32 * cos((3 * Hbarprimed + 6) * PI / 180.0) -
-                         0.20 * cos((4 * Hbarprimed - 63) * PI / 180.0);
-
-          double SL = 1 + (0.015 * pow(Lbar - 50, 2.0) /
-                           sqrt(20 + pow(Lbar - 50, 2.0)));
-          double SC = 1 + 0.045 * Cbarprimed;
-          double SH = 1 + 0.015 * Cbarprimed * T;
-
-          double RT = 
-              -2 * 
-              sqrt(pow(Cbarprimed, 7.0) / 
-                   (pow(Cbarprimed, 7.0) + 6103515625)) * 
-              sin((60 * exp(-pow((Hbarprimed - 275) / 25, 2.0))) * PI / 180.0);
-
-          dE_value = sqrt(pow(deltaLprimed / kL / SL, 2.0) +
-                          pow(deltaCprimed / kC / SC, 2.0) +
-                          pow(deltaHprimed / kH / SH, 2.0) +
-                          RT * (deltaCprimed / kC / SC) * 
-                               (deltaHprimed / kH / SH));
-        }
+// CIEDE2000 of a row of interleaved L*a*b* pixels, AVX2 requires
+// IMGS_ENABLE_AVX2 (SSE2 is part of every x86-64 target)
+void FastDeltaE2000Row(const float* lab1, const float* lab2, float* dE,
+                       const int cols) {
+  int c = 0;
+#if defined(__AVX2__)
+  c = FastDeltaE2000Vectors<Avx2Ops>(lab1, lab2, dE, cols);
+#elif defined(__SSE2__)
+  c = FastDeltaE2000Vectors<Sse2Ops>(lab1, lab2, dE, cols);
+#endif
+  for (; c < cols; c++) {
+    dE[c] = FastDeltaE2000(lab1 + 3 * c, lab2 + 3 * c);
+  }
+}
+
+double DeltaE1994(const cv::Vec3f& lab1_value, const cv::Vec3f& lab2_value,
+                  const double kL, const double K1, const double K2) {
+  double kC = 1.0;
+  double kH = 1.0;
+
+  double Lstar1 = lab1_value[0];
+  double astar1 = lab1_value[1];
+  double bstar1 = lab1_value[2];
+
+  double Lstar2 = lab2_value[0];
+  double astar2 = lab2_value[1];
+  double bstar2 = lab2_value[2];
+
+  double deltaLstar = Lstar1 - Lstar2;
+
+  double Cstar1 = sqrt(pow(astar1, 2.0) + pow(bstar1, 2.0));
+  double Cstar2 = sqrt(pow(astar2, 2.0) + pow(bstar2, 2.0));
+  double deltaCstarab = Cstar1 - Cstar2;
+
+  double deltaastar = astar1 - astar2;
+  double deltabstar = bstar1 - bstar2;
+
+  double deltaHstarab = sqrt(pow(deltaastar, 2.0) + 
+                             pow(deltabstar, 2.0) - 
+                             pow(deltaCstarab, 2.0));
+
+  double SL = 1.0;
+  double SC = 1.0 + K1 * Cstar1;
+  double SH = 1.0 + K2 * Cstar1;
+
+  return sqrt(pow(deltaLstar / kL / SL, 2.0) +
+              pow(deltaCstarab / kC / SC, 2.0) +
+              pow(deltaHstarab / kH / SH, 2.0));
+}
+}
+
+double DeltaE2000(const cv::Vec3f& lab1_value,
+                  const cv::Vec3f& lab2_value) {
+  double tolerance = 1.0e-15;
+  const double PI = 3.141592653589793238463;
+
+  double kL = 1.0;
+  double kC = 1.0;
+  double kH = 1.0;
+
+  double Lstar1 = lab1_value[0];
+  double astar1 = lab1_value[1];
+  double bstar1 = lab1_value[2];
+
+  double Lstar2 = lab2_value[0];
+  double astar2 = lab2_value[1];
+  double bstar2 = lab2_value[2];
+
+  double deltaLprimed = Lstar2 - Lstar1;
+
+  double Lbar = (Lstar1 + Lstar2) / 2.0;
+
+  double Cstar1 = sqrt(pow(astar1, 2.0) + pow(bstar1, 2.0));
+  double Cstar2 = sqrt(pow(astar2, 2.0) + pow(bstar2, 2.0));
+  double Cbar = (Cstar1 + Cstar2) / 2.0;
+
+  double aprimed1 = astar1 + astar1 / 2.0 * 
+      (1 - sqrt(pow(Cbar, 7.0) / (pow(Cbar, 7.0) + 6103515625)));
+  double aprimed2 = astar2 + astar2 / 2.0 * 
+      (1 - sqrt(pow(Cbar, 7.0) / (pow(Cbar, 7.0) + 6103515625)));
+
+  double Cprimed1 = sqrt(aprimed1 * aprimed1 + bstar1 * bstar1);
+  double Cprimed2 = sqrt(aprimed2 * aprimed2 + bstar2 * bstar2);
+  double deltaCprimed = Cprimed2 - Cprimed1;
+  double Cbarprimed = (Cprimed1 + Cprimed2) / 2.0;
+
+  double hprimed1;
+  if ((abs(bstar1) < tolerance) && (abs(aprimed1) < tolerance)) {
+    hprimed1 = 0;
+  } else {
+    hprimed1 = atan2(bstar1, aprimed1) * 180 / PI;
+    if (hprimed1 < 0) {
+      hprimed1 += 360;
+    }
+  }
+  double hprimed2;
+  if ((abs(bstar2) < tolerance) && (abs(aprimed2) < tolerance)) {
+    hprimed2 = 0;
+  } else {
+    hprimed2 = atan2(bstar2, aprimed2) * 180 / PI;
+    if (hprimed2 < 0) {
+      hprimed2 += 360;
+    }
+  }
+
+  double deltahprimed;
+  if ((abs(Cprimed1) < tolerance) || (abs(Cprimed2) < tolerance)) {
+    deltahprimed = 0;
+  } else {
+    double temp = abs(hprimed1 - hprimed2);
+    if (temp <= 180) {
+      deltahprimed = hprimed2 - hprimed1;
+    } else if ((temp > 180) && (hprimed2 <= hprimed1)) {
+      deltahprimed = hprimed2 - hprimed1 + 360;
+    } else if ((temp > 180) && (hprimed2 > hprimed1)) {
+      deltahprimed = hprimed2 - hprimed1 - 360;
+    }
+  }
+
+  double Hbarprimed;
+  if ((abs(Cprimed1) < tolerance) || (abs(Cprimed2) < tolerance)) {
+    Hbarprimed = hprimed1 + hprimed2;
+  } else {
+    double temp = abs(hprimed1 - hprimed2);
+    if (temp <= 180) {
+      Hbarprimed = (hprimed1 + hprimed2) / 2.0;
+    } else if ((temp > 180) && ((hprimed1 + hprimed2) < 360)) {
+      Hbarprimed = (hprimed1 + hprimed2 + 360) / 2.0;
+    } else if ((temp > 180) && ((hprimed1 + hprimed2) >= 360)) {
+      Hbarprimed = (hprimed1 + hprimed2 - 360) / 2.0;
+    }
+  }
+
+  double deltaHprimed = 2 * sqrt(Cprimed1 * Cprimed2) * 
+                        sin((deltahprimed / 2) * PI / 180.0);
+
+  double T = 1 - 0.17 * cos((Hbarprimed - 30) * PI / 180.0) +
+                 0.24 * cos((2 * Hbarprimed) * PI / 180.0) +
+                 0.32 * cos((3 * Hbarprimed + 6) * PI / 180.0) -
+                 0.20 * cos((4 * Hbarprimed - 63) * PI / 180.0);
+
+  double SL = 1 + (0.015 * pow(Lbar - 50, 2.0) /
+                   sqrt(20 + pow(Lbar - 50, 2.0)));
+  double SC = 1 + 0.045 * Cbarprimed;
+  double SH = 1 + 0.015 * Cbarprimed * T;
+
+  double RT = 
+      -2 * 
+      sqrt(pow(Cbarprimed, 7.0) / 
+           (pow(Cbarprimed, 7.0) + 6103515625)) * 
+      sin((60 * exp(-pow((Hbarprimed - 275) / 25, 2.0))) * PI / 180.0);
+
+  return sqrt(pow(deltaLprimed / kL / SL, 2.0) +
+              pow(deltaCprimed / kC / SC, 2.0) +
+              pow(deltaHprimed / kH / SH, 2.0) +
+              RT * (deltaCprimed / kC / SC) * (deltaHprimed / kH / SH));
+}
+
+
+DeltaEKernel::DeltaEKernel(const int standard, const string& application)
+    : standard_(standard), kL_(1.0), K1_(0.045), K2_(0.015) {
+  switch (standard) {
+    case 1976:
+    case 2000:
+      break;
+
+    case 1994:
+      if (application == "graphic_arts") {
+        kL_ = 1.0;
+        K1_ = 0.045;
+        K2_ = 0.015;
+      } else if (application == "textiles") {
+        kL_ = 2.0;
+        K1_ = 0.048;
+        K2_ = 0.014;
+      } else {
+        cerr << "Specified application for delta E 1994 not supported: "
+             << application << endl;
+        exit(EXIT_FAILURE);
       }
       break;
-    }
 
     default:
       cerr << "Specified delta E standard not implemented: " << standard 
            << endl;
       exit(EXIT_FAILURE);
+  }
+}
+
+void DeltaEKernel::Row(const cv::Vec3f* lab1, const cv::Vec3f* lab2,
+                       float* dE, const int cols) const {
+  switch (standard_) {
+    case 1976:
+      for (int c = 0; c < cols; c++) {
+        float deltaLstar = lab1[c][0] - lab2[c][0];
+        float deltaastar = lab1[c][1] - lab2[c][1];
+        float deltabstar = lab1[c][2] - lab2[c][2];
+        dE[c] = sqrt(deltaLstar * deltaLstar + deltaastar * deltaastar +
+                     deltabstar * deltabstar);
+      }
+      break;
 
+    case 1994:
+      for (int c = 0; c < cols; c++) {
+        dE[c] = static_cast<float>(
+            DeltaE1994(lab1[c], lab2[c], kL_, K1_, K2_));
+      }
+      break;
+
+    default:
+      // Vectorized single precision formula (see DeltaE2000 for the double
+      // precision reference)
+      FastDeltaE2000Row(lab1[0].val, lab2[0].val, dE, cols);
+      break;
+  }
+}
+
+double DeltaE(const cv::Mat& src1, const cv::Mat& src2, cv::Mat& dE,
+              int max_value, int standard, string application, int grid) {
+  if ((src1.rows != src2.rows) || (src1.cols != src2.cols) ||
+      (src1.channels() != src2.channels())) {
+    cerr << "Image dimensions must match exactly for PSNR computation" << endl;
+    exit(EXIT_FAILURE);
   }
 
+  if (src1.channels() != 3) {
+    cerr << "Images must be 3-channel for delta E computation" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  const DeltaEKernel kernel(standard, application);
+
+  // The L*a*b* values are streamed row by row from the sources, no
+  // normalized or L*a*b* copies of the images are held
+  const LabLut lut1(src1.depth(), max_value, grid);
+  const LabLut lut2(src2.depth(), max_value, grid);
+
+  dE.create(src1.rows, src1.cols, CV_32F);
+  double sum = 0;
+  mutex sum_mutex;
+  cv::parallel_for_(cv::Range(0, dE.rows), [&](const cv::Range& range) {
+    vector<cv::Vec3f> lab1(dE.cols);
+    vector<cv::Vec3f> lab2(dE.cols);
+    double stripe_sum = 0;
+    for (int r = range.start; r < range.end; r++) {
+      lut1.ConvertRow(src1, r, lab1.data());
+      lut2.ConvertRow(src2, r, lab2.data());
+      float* d = dE.ptr<float>(r);
+      kernel.Row(lab1.data(), lab2.data(), d, dE.cols);
+      for (int c = 0; c < dE.cols; c++) {
+        stripe_sum += d[c];
+      }
+    }
+    lock_guard<mutex> lock(sum_mutex);
+    sum += stripe_sum;
+  });
+
   // Compute the mean delta E
-  cv::Scalar temp = mean(dE);
-  deltae = static_cast<double>(temp.val[0]);
+  double deltae = sum / dE.total();
 
   return deltae;
 }
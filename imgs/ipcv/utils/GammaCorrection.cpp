@@ -5,42 +5,60 @@
  *  \date 29 Dec 2018
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 #include "GammaCorrection.h"
 
+#include "imgs/ipcv/utils/ApplyLut.h"
+
 using namespace std;
 
 namespace ipcv {
 
-cv::Mat GammaCorrection(const cv::Mat& src, const double gamma,
-                        const int max_value) {
-  int type = src.type();
-  uchar depth = type & CV_MAT_DEPTH_MASK;
-  uchar channels = 1 + (type >> CV_CN_SHIFT);
+namespace {
+
+// Number of LUTs kept by the process-wide cache
+const size_t kGammaLutCacheCapacity = 16;
 
+struct CachedLut {
+  double exponent;
+  int max_value;
+  int depth;
+  uint64_t last_used;
+  cv::Mat lut;
+};
+
+mutex cache_mutex;
+vector<CachedLut> cache;
+uint64_t cache_clock = 0;
+
+// value = (dc / max_value)^exponent * max_value, rounded and saturated
+cv::Mat ComputeLut(const int depth, const double exponent,
+                   const int max_value) {
   cv::Mat lut;
-  lut.create(channels, max_value + 1, depth);
   switch (depth) {
     case CV_8U:
-      for (int dc = 0; dc <= max_value; dc++) {
-        uint8_t value = static_cast<uint8_t>(
-            pow(dc / static_cast<double>(max_value), 1 / gamma) * max_value +
-            0.5);
-        for (int b = 0; b < channels; b++) {
-          lut.at<uint8_t>(b, dc) = value;
-        }
+      lut.create(1, 256, CV_8UC1);
+      for (int dc = 0; dc < 256; dc++) {
+        double value =
+            pow(dc / static_cast<double>(max_value), exponent) * max_value +
+            0.5;
+        lut.at<uint8_t>(0, dc) = static_cast<uint8_t>(min(value, 255.));
       }
       break;
 
     case CV_16U:
-      for (int dc = 0; dc <= max_value; dc++) {
-        uint16_t value = static_cast<uint16_t>(
-            pow(dc / static_cast<double>(max_value), 1 / gamma) * max_value +
-            0.5);
-        for (int b = 0; b < channels; b++) {
-          lut.at<uint16_t>(b, dc) = value;
-        }
+      lut.create(1, 65536, CV_16UC1);
+      for (int dc = 0; dc < 65536; dc++) {
+        double value =
+            pow(dc / static_cast<double>(max_value), exponent) * max_value +
+            0.5;
+        lut.at<uint16_t>(0, dc) = static_cast<uint16_t>(min(value, 65535.));
       }
       break;
 
@@ -48,55 +66,68 @@ cv::Mat GammaCorrection(const cv::Mat& src, const double gamma,
       cerr << "Unsupported data type for gamma correction" << endl;
       exit(EXIT_FAILURE);
   }
+  return lut;
+}
 
-  cv::Mat dst;
-  dst.create(src.size(), type);
-  switch (depth) {
-    case CV_8U:
-      if (channels == 3) {
-        for (int r = 0; r < src.rows; r++) {
-          for (int c = 0; c < src.cols; c++) {
-            const auto& src_dc = src.at<cv::Vec3b>(r, c);
-            auto& dst_dc = dst.at<cv::Vec3b>(r, c);
-            dst_dc[0] = lut.at<uint8_t>(0, src_dc[0]);
-            dst_dc[1] = lut.at<uint8_t>(1, src_dc[1]);
-            dst_dc[2] = lut.at<uint8_t>(2, src_dc[2]);
-          }
-        }
-      } else {
-        for (int r = 0; r < src.rows; r++) {
-          for (int c = 0; c < src.cols; c++) {
-            const auto& src_dc = src.at<uint8_t>(r, c);
-            auto& dst_dc = dst.at<uint8_t>(r, c);
-            dst_dc = lut.at<uint8_t>(0, src_dc);
-          }
-        }
+// The returned LUT shares its data with the cache, it is only ever read
+// within this file and copied before it is handed out
+cv::Mat CachedPowerLut(const int depth, const double exponent,
+                       const int max_value) {
+  {
+    lock_guard<mutex> lock(cache_mutex);
+    for (auto& entry : cache) {
+      if (entry.exponent == exponent && entry.max_value == max_value &&
+          entry.depth == depth) {
+        entry.last_used = ++cache_clock;
+        return entry.lut;
       }
-      break;
+    }
+  }
 
-    case CV_16U:
-      if (channels == 3) {
-        for (int r = 0; r < src.rows; r++) {
-          for (int c = 0; c < src.cols; c++) {
-            const auto& src_dc = src.at<cv::Vec<uint16_t, 3>>(r, c);
-            auto& dst_dc = dst.at<cv::Vec<uint16_t, 3>>(r, c);
-            dst_dc[0] = lut.at<uint16_t>(0, src_dc[0]);
-            dst_dc[1] = lut.at<uint16_t>(1, src_dc[1]);
-            dst_dc[2] = lut.at<uint16_t>(2, src_dc[2]);
-          }
-        }
-      } else {
-        for (int r = 0; r < src.rows; r++) {
-          for (int c = 0; c < src.cols; c++) {
-            const auto& src_dc = src.at<uint16_t>(r, c);
-            auto& dst_dc = dst.at<uint16_t>(r, c);
-            dst_dc = lut.at<uint16_t>(0, src_dc);
-          }
-        }
-      }
-      break;
+  // Compute outside of the lock so other parameters are not held up (two
+  // threads may compute the same table, the second insertion is dropped)
+  cv::Mat lut = ComputeLut(depth, exponent, max_value);
+
+  lock_guard<mutex> lock(cache_mutex);
+  for (auto& entry : cache) {
+    if (entry.exponent == exponent && entry.max_value == max_value &&
+        entry.depth == depth) {
+      entry.last_used = ++cache_clock;
+      return entry.lut;
+    }
   }
+  if (cache.size() >= kGammaLutCacheCapacity) {
+    // Evict the least recently used table
+    auto oldest = min_element(cache.begin(), cache.end(),
+                              [](const CachedLut& a, const CachedLut& b) {
+                                return a.last_used < b.last_used;
+                              });
+    cache.erase(oldest);
+  }
+  cache.push_back({exponent, max_value, depth, ++cache_clock, lut});
+  return lut;
+}
+}
+
+cv::Mat GammaLut(const int depth, const double gamma, const int max_value) {
+  return CachedPowerLut(depth, 1 / gamma, max_value).clone();
+}
 
+cv::Mat InverseGammaLut(const int depth, const double gamma,
+                        const int max_value) {
+  return CachedPowerLut(depth, gamma, max_value).clone();
+}
+
+cv::Mat GammaCorrection(const cv::Mat& src, const double gamma,
+                        const int max_value) {
+  cv::Mat dst;
+  ApplyLut(src, CachedPowerLut(src.depth(), 1 / gamma, max_value), dst);
   return dst;
 }
+
+void GammaCorrectionInPlace(cv::Mat& image, const double gamma,
+                            const int max_value) {
+  ApplyLut(image, CachedPowerLut(image.depth(), 1 / gamma, max_value),
+           image);
+}
 }
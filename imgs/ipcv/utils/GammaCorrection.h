@@ -1,6 +1,6 @@
-/** Interface file for computing the PSNR between two images
+/** Interface file for applying gamma correction to a source image
  *
- *  \file ipcv/utils/Psnr.h
+ *  \file ipcv/utils/GammaCorrection.h
  *  \author Carl Salvaggio, Ph.D. (salvaggio@cis.rit.edu)
  *  \date 28 Dec 2018
  */
@@ -11,9 +11,40 @@
 
 namespace ipcv {
 
-/** Compute the 3-channel image histogram of the provided source image
+/** Create the LUT that applies gamma correction
  *
- *  \param[in] src         source cv::Mat of CV_8UC3 or CV_16UC3
+ *  LUTs are kept in a bounded, thread-safe cache shared by the whole
+ *  process (keyed by gamma, max_value and depth), so repeated calls with
+ *  the same parameters do not recompute the table.  The returned LUT is a
+ *  copy owned by the caller, modifying it does not affect later calls.
+ *
+ *  \param[in] depth       depth of the images the LUT applies to, CV_8U or
+ *                         CV_16U
+ *  \param[in] gamma       gamma to be applied
+ *  \param[in] max_value   maximum possible value data sources may take on
+ *
+ *  \return                single row LUT of 256 (CV_8U) or 65536 (CV_16U)
+ *                         entries, values above max_value saturate
+ */
+cv::Mat GammaLut(const int depth, const double gamma = 2.2,
+                 const int max_value = 255);
+
+/** Create the LUT that undoes gamma correction (see GammaLut)
+ *
+ *  \param[in] depth       depth of the images the LUT applies to, CV_8U or
+ *                         CV_16U
+ *  \param[in] gamma       gamma to be undone
+ *  \param[in] max_value   maximum possible value data sources may take on
+ *
+ *  \return                single row LUT of 256 (CV_8U) or 65536 (CV_16U)
+ *                         entries, values above max_value saturate
+ */
+cv::Mat InverseGammaLut(const int depth, const double gamma = 2.2,
+                        const int max_value = 255);
+
+/** Apply gamma correction to a source image
+ *
+ *  \param[in] src         source cv::Mat of CV_8UC(n) or CV_16UC(n)
  *  \param[in] gamma       gamma to be applied
  *  \param[in] max_value   maximum possible value data sources may take on
  *
@@ -21,4 +52,14 @@ namespace ipcv {
  */
 cv::Mat GammaCorrection(const cv::Mat& src, const double gamma = 2.2,
                         const int max_value = 255);
+
+/** Apply gamma correction to an image in place (no destination image is
+ *  allocated)
+ *
+ *  \param[in,out] image   cv::Mat of CV_8UC(n) or CV_16UC(n)
+ *  \param[in] gamma       gamma to be applied
+ *  \param[in] max_value   maximum possible value data sources may take on
+ */
+void GammaCorrectionInPlace(cv::Mat& image, const double gamma = 2.2,
+                            const int max_value = 255);
 }
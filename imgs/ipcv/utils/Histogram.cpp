@@ -7,17 +7,107 @@
 
 #include "Histogram.h"
 
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
 namespace ipcv {
 
-void Histogram(const cv::Mat& src, cv::Mat& h) {
-  h = cv::Mat_<int>::zeros(3, 256);
-  for (int r = 0; r < src.rows; r++) {
-    for (int c = 0; c < src.cols; c++) {
-      auto value = src.at<cv::Vec3b>(r, c);
-      h.at<int>(0, value[0])++;
-      h.at<int>(1, value[1])++;
-      h.at<int>(2, value[2])++;
+namespace {
+
+// Images smaller than this are histogrammed on the calling thread only
+const int kMinParallelPixels = 1 << 16;
+
+// Accumulate the histogram of rows [r0, r1) into `copies` interleaved
+// sub-histograms of channels x bins counts each.  Consecutive pixels are
+// counted into different sub-histograms so that runs of equal values do
+// not serialize on incrementing the same counter.
+template <typename T, int channels, int copies>
+void Accumulate(const cv::Mat& src, const int r0, const int r1,
+                const int bins, int* counts) {
+  const int stride = channels * bins;
+  for (int r = r0; r < r1; r++) {
+    const T* p = src.ptr<T>(r);
+    int c = 0;
+    for (; c + copies <= src.cols; c += copies) {
+      for (int k = 0; k < copies; k++) {
+        int* h = counts + k * stride;
+        for (int b = 0; b < channels; b++) {
+          h[b * bins + p[(c + k) * channels + b]]++;
+        }
+      }
     }
+    for (; c < src.cols; c++) {
+      for (int b = 0; b < channels; b++) {
+        counts[b * bins + p[c * channels + b]]++;
+      }
+    }
+  }
+}
+
+template <typename T, int channels>
+void Compute(const cv::Mat& src, cv::Mat& h) {
+  const int bins = 1 << (8 * sizeof(T));
+  // Interleaving only pays off for the small 8-bit tables; 16-bit tables
+  // are large enough that neighbouring values rarely share a counter
+  const int copies = sizeof(T) == 1 ? 4 : 1;
+  const int size = channels * bins;
+
+  h = cv::Mat_<int>::zeros(channels, bins);
+  int* total = h.ptr<int>(0);
+  mutex total_mutex;
+
+  auto band = [&](const cv::Range& range) {
+    vector<int> counts(copies * size, 0);
+    Accumulate<T, channels, copies>(src, range.start, range.end, bins,
+                                    counts.data());
+    for (int k = 1; k < copies; k++) {
+      const int* copy = &counts[k * size];
+      for (int i = 0; i < size; i++) {
+        counts[i] += copy[i];
+      }
+    }
+    lock_guard<mutex> lock(total_mutex);
+    for (int i = 0; i < size; i++) {
+      total[i] += counts[i];
+    }
+  };
+
+  if (src.total() < static_cast<size_t>(kMinParallelPixels)) {
+    band(cv::Range(0, src.rows));
+  } else {
+    int stripes = min(src.rows, max(cv::getNumThreads(), 1));
+    cv::parallel_for_(cv::Range(0, src.rows), band, stripes);
+  }
+}
+}
+
+void Histogram(const cv::Mat& src, cv::Mat& h) {
+  switch (src.type()) {
+    case CV_8UC1:
+      Compute<uint8_t, 1>(src, h);
+      break;
+    case CV_8UC3:
+      Compute<uint8_t, 3>(src, h);
+      break;
+    case CV_8UC4:
+      Compute<uint8_t, 4>(src, h);
+      break;
+    case CV_16UC1:
+      Compute<uint16_t, 1>(src, h);
+      break;
+    case CV_16UC3:
+      Compute<uint16_t, 3>(src, h);
+      break;
+    case CV_16UC4:
+      Compute<uint16_t, 4>(src, h);
+      break;
+    default:
+      cerr << "Unsupported data type for histogram" << endl;
+      exit(EXIT_FAILURE);
   }
 }
 }
@@ -11,10 +11,17 @@
 
 namespace ipcv {
 
-/** Compute the 3-channel image histogram of the provided source image
+/** Compute the per-channel image histogram of the provided source image
  *
- *  \param[in] src  source cv::Mat of CV_8UC3
- *  \param[out] h   the grey-level histogram for the source image
+ *  Bands of rows are histogrammed in parallel, each into several
+ *  interleaved private sub-histograms (consecutive pixels increment
+ *  different copies of a bin) that are merged at the end.
+ *
+ *  \param[in] src  source cv::Mat of CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC1,
+ *                  CV_16UC3 or CV_16UC4
+ *  \param[out] h   the grey-level histogram for the source image, a
+ *                  cv::Mat of CV_32SC1 with one row per channel and 256
+ *                  (8-bit) or 65536 (16-bit) columns
  */
 void Histogram(const cv::Mat& src, cv::Mat& h);
 }
@@ -16,13 +16,11 @@ void HistogramToCdf(const cv::Mat& h, cv::Mat& cdf) {
   HistogramToPdf(h, pdf);
 
   cdf.create(h.size(), CV_64F);
-  cdf.at<double>(0, 0) = pdf.at<double>(0, 0);
-  cdf.at<double>(1, 0) = pdf.at<double>(1, 0);
-  cdf.at<double>(2, 0) = pdf.at<double>(2, 0);
-  for (int dc = 1; dc < 256; dc++) {
-    cdf.at<double>(0, dc) = cdf.at<double>(0, dc - 1) + pdf.at<double>(0, dc);
-    cdf.at<double>(1, dc) = cdf.at<double>(1, dc - 1) + pdf.at<double>(1, dc);
-    cdf.at<double>(2, dc) = cdf.at<double>(2, dc - 1) + pdf.at<double>(2, dc);
+  for (int b = 0; b < h.rows; b++) {
+    cdf.at<double>(b, 0) = pdf.at<double>(b, 0);
+    for (int dc = 1; dc < h.cols; dc++) {
+      cdf.at<double>(b, dc) = cdf.at<double>(b, dc - 1) + pdf.at<double>(b, dc);
+    }
   }
 }
 }
@@ -13,7 +13,7 @@ namespace ipcv {
 
 /** Compute the cumulative density function from a 3-channel image histogram
  *
- *  \param[in] h   the 3-channel image histogram
+ *  \param[in] h   the per-channel image histogram
  *  \param[out] cdf the cumulative density for the supplied histogram
  */
 void HistogramToCdf(const cv::Mat& h, cv::Mat& cdf);
@@ -12,10 +12,10 @@ namespace ipcv {
 void HistogramToPdf(const cv::Mat& h, cv::Mat& pdf) {
   pdf.create(h.size(), CV_64F);
   double number_pixels = cv::sum(h.row(0))[0];
-  for (int dc = 0; dc < 256; dc++) {
-    pdf.at<double>(0, dc) = h.at<int>(0, dc) / number_pixels;
-    pdf.at<double>(1, dc) = h.at<int>(1, dc) / number_pixels;
-    pdf.at<double>(2, dc) = h.at<int>(2, dc) / number_pixels;
+  for (int b = 0; b < h.rows; b++) {
+    for (int dc = 0; dc < h.cols; dc++) {
+      pdf.at<double>(b, dc) = h.at<int>(b, dc) / number_pixels;
+    }
   }
 }
 }
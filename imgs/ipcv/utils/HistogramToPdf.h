@@ -13,7 +13,7 @@ namespace ipcv {
 
 /** Compute the probability density function from a 3-channel image histogram
  *
- *  \param[in] h   the 3-channel image histogram
+ *  \param[in] h   the per-channel image histogram
  *  \param[out] pdf the probability density for the supplied histogram
  */
 void HistogramToPdf(const cv::Mat& h, cv::Mat& pdf);
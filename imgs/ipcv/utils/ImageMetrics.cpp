@@ -0,0 +1,345 @@
+/** Implementation file for computing image comparison metrics in a single
+ *  pass
+ *
+ *  \file ipcv/utils/ImageMetrics.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "ImageMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "imgs/ipcv/utils/DeltaE.h"
+#include "imgs/ipcv/utils/LabLut.h"
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+// Squared and largest absolute error of a row of values, Accumulator is
+// wide enough for the squared difference of any two values of T
+template <typename T, typename Accumulator>
+void ErrorRow(const T* s1, const T* s2, const int n, Accumulator& sse,
+              Accumulator& max_error) {
+  for (int i = 0; i < n; i++) {
+    Accumulator d = static_cast<Accumulator>(s1[i]) -
+                    static_cast<Accumulator>(s2[i]);
+    d = d < 0 ? -d : d;
+    sse += d * d;
+    max_error = max(max_error, d);
+  }
+}
+
+// Rows are accumulated in blocks of values small enough for 8-bit squared
+// errors to be summed in 32-bit integers (32768 x 255^2 < 2^31)
+const int kBlock = 32768;
+
+template <typename T, typename Accumulator>
+void ErrorRow(const cv::Mat& src1, const cv::Mat& src2, const int row,
+              double& sse, double& max_error) {
+  const T* s1 = src1.ptr<T>(row);
+  const T* s2 = src2.ptr<T>(row);
+  const int n = src1.cols * src1.channels();
+  for (int i = 0; i < n; i += kBlock) {
+    Accumulator block_sse = 0;
+    Accumulator block_max_error = 0;
+    ErrorRow(s1 + i, s2 + i, min(kBlock, n - i), block_sse, block_max_error);
+    sse += static_cast<double>(block_sse);
+    max_error = max(max_error, static_cast<double>(block_max_error));
+  }
+}
+
+void ErrorRow(const cv::Mat& src1, const cv::Mat& src2, const int row,
+              double& sse, double& max_error) {
+  switch (src1.depth()) {
+    case CV_8U:
+      ErrorRow<uint8_t, int32_t>(src1, src2, row, sse, max_error);
+      break;
+    case CV_8S:
+      ErrorRow<int8_t, int32_t>(src1, src2, row, sse, max_error);
+      break;
+    case CV_16U:
+      ErrorRow<uint16_t, int64_t>(src1, src2, row, sse, max_error);
+      break;
+    case CV_16S:
+      ErrorRow<int16_t, int64_t>(src1, src2, row, sse, max_error);
+      break;
+    case CV_32S:
+      ErrorRow<int32_t, double>(src1, src2, row, sse, max_error);
+      break;
+    case CV_32F:
+      ErrorRow<float, double>(src1, src2, row, sse, max_error);
+      break;
+    default:
+      ErrorRow<double, double>(src1, src2, row, sse, max_error);
+      break;
+  }
+}
+
+// Byte-wise equality of two ranges of memory
+bool BytesEqual(const uint8_t* a, const uint8_t* b, const size_t n) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) != -1) {
+      return false;
+    }
+  }
+#elif defined(__SSE2__)
+  for (; i + 16 <= n; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF) {
+      return false;
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (a[i] != b[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+double Psnr(const double sse, const double values, const int max_value) {
+  return 10.0 *
+         log10(static_cast<double>(max_value) * max_value / (sse / values));
+}
+}
+
+ImageMetrics CompareImages(const cv::Mat& src1, const cv::Mat& src2,
+                           const int max_value, const int standard,
+                           const string& application, cv::Mat* dE,
+                           const int grid) {
+  if (src1.size() != src2.size() || src1.type() != src2.type()) {
+    cerr << "Image dimensions and types must match exactly for image "
+         << "comparison" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // Delta E is evaluated on L*a*b* rows streamed from the sources
+  unique_ptr<DeltaEKernel> kernel;
+  unique_ptr<LabLut> lut;
+  if (standard != 0) {
+    if (src1.channels() != 3) {
+      cerr << "Images must be 3-channel for delta E computation" << endl;
+      exit(EXIT_FAILURE);
+    }
+    kernel.reset(new DeltaEKernel(standard, application));
+    lut.reset(new LabLut(src1.depth(), max_value, grid));
+    if (dE) {
+      dE->create(src1.size(), CV_32FC1);
+    }
+  }
+
+  double sse = 0;
+  double max_error = 0;
+  double delta_e_sum = 0;
+  mutex sum_mutex;
+  cv::parallel_for_(cv::Range(0, src1.rows), [&](const cv::Range& range) {
+    double stripe_sse = 0;
+    double stripe_max_error = 0;
+    double stripe_delta_e_sum = 0;
+    vector<cv::Vec3f> lab1;
+    vector<cv::Vec3f> lab2;
+    vector<float> delta_e;
+    if (kernel) {
+      lab1.resize(src1.cols);
+      lab2.resize(src1.cols);
+      delta_e.resize(src1.cols);
+    }
+
+    for (int r = range.start; r < range.end; r++) {
+      ErrorRow(src1, src2, r, stripe_sse, stripe_max_error);
+
+      if (kernel) {
+        lut->ConvertRow(src1, r, lab1.data());
+        lut->ConvertRow(src2, r, lab2.data());
+        float* d = dE ? dE->ptr<float>(r) : delta_e.data();
+        kernel->Row(lab1.data(), lab2.data(), d, src1.cols);
+        for (int c = 0; c < src1.cols; c++) {
+          stripe_delta_e_sum += d[c];
+        }
+      }
+    }
+
+    lock_guard<mutex> lock(sum_mutex);
+    sse += stripe_sse;
+    max_error = max(max_error, stripe_max_error);
+    delta_e_sum += stripe_delta_e_sum;
+  });
+
+  const double pixels = static_cast<double>(src1.rows) * src1.cols;
+
+  ImageMetrics metrics;
+  metrics.sse = sse;
+  metrics.mse = sse / (pixels * src1.channels());
+  metrics.rmse = sqrt(metrics.mse);
+  metrics.psnr = Psnr(sse, pixels * src1.channels(), max_value);
+  metrics.max_error = max_error;
+  metrics.delta_e = kernel ? delta_e_sum / pixels : 0;
+
+  return metrics;
+}
+
+TileComparison CompareTiles(const cv::Mat& src1, const cv::Mat& src2,
+                            const int max_value,
+                            const TileThresholds& thresholds,
+                            const int tile_size, const bool early_exit,
+                            const int standard, const string& application,
+                            const int grid) {
+  if (src1.size() != src2.size() || src1.type() != src2.type()) {
+    cerr << "Image dimensions and types must match exactly for image "
+         << "comparison" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (tile_size < 1) {
+    cerr << "Tile size must be positive for image comparison" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  unique_ptr<DeltaEKernel> kernel;
+  unique_ptr<LabLut> lut;
+  if (standard != 0) {
+    if (src1.channels() != 3) {
+      cerr << "Images must be 3-channel for delta E computation" << endl;
+      exit(EXIT_FAILURE);
+    }
+    kernel.reset(new DeltaEKernel(standard, application));
+    lut.reset(new LabLut(src1.depth(), max_value, grid));
+  }
+
+  const int tile_rows = (src1.rows + tile_size - 1) / tile_size;
+  const int tile_cols = (src1.cols + tile_size - 1) / tile_size;
+
+  TileComparison tiles;
+  tiles.state = cv::Mat::zeros(tile_rows, tile_cols, CV_8UC1);
+  tiles.sse = cv::Mat::zeros(tile_rows, tile_cols, CV_64FC1);
+  tiles.psnr = cv::Mat::zeros(tile_rows, tile_cols, CV_64FC1);
+  tiles.max_error = cv::Mat::zeros(tile_rows, tile_cols, CV_64FC1);
+  if (kernel) {
+    tiles.delta_e = cv::Mat::zeros(tile_rows, tile_cols, CV_64FC1);
+    tiles.max_delta_e = cv::Mat::zeros(tile_rows, tile_cols, CV_64FC1);
+  }
+
+  atomic<bool> stop(false);
+  atomic<int> different_tiles(0);
+  cv::parallel_for_(
+      cv::Range(0, tile_rows * tile_cols), [&](const cv::Range& range) {
+        vector<cv::Vec3f> lab1;
+        vector<cv::Vec3f> lab2;
+        vector<float> delta_e;
+        if (kernel) {
+          lab1.resize(tile_size);
+          lab2.resize(tile_size);
+          delta_e.resize(tile_size);
+        }
+
+        for (int t = range.start; t < range.end && !stop; t++) {
+          const int tr = t / tile_cols;
+          const int tc = t % tile_cols;
+          cv::Rect rect(tc * tile_size, tr * tile_size,
+                        min(tile_size, src1.cols - tc * tile_size),
+                        min(tile_size, src1.rows - tr * tile_size));
+          const cv::Mat tile1 = src1(rect);
+          const cv::Mat tile2 = src2(rect);
+
+          bool identical = true;
+          for (int r = 0; r < tile1.rows && identical; r++) {
+            identical = BytesEqual(tile1.ptr<uint8_t>(r),
+                                   tile2.ptr<uint8_t>(r),
+                                   tile1.cols * tile1.elemSize());
+          }
+          if (identical) {
+            tiles.state.at<uint8_t>(tr, tc) =
+                static_cast<uint8_t>(TileState::identical);
+            tiles.psnr.at<double>(tr, tc) =
+                numeric_limits<double>::infinity();
+            continue;
+          }
+
+          double sse = 0;
+          double max_error = 0;
+          double delta_e_sum = 0;
+          double max_delta_e = 0;
+          bool crossed = false;
+          int rows_read = 0;
+          // With early exit a tile also stops once another tile has been
+          // found to differ
+          for (int r = 0; r < tile1.rows && !crossed && !stop; r++) {
+            ErrorRow(tile1, tile2, r, sse, max_error);
+            if (kernel) {
+              lut->ConvertRow(tile1, r, lab1.data());
+              lut->ConvertRow(tile2, r, lab2.data());
+              kernel->Row(lab1.data(), lab2.data(), delta_e.data(),
+                          tile1.cols);
+              for (int c = 0; c < tile1.cols; c++) {
+                delta_e_sum += delta_e[c];
+                max_delta_e = max(max_delta_e, static_cast<double>(delta_e[c]));
+              }
+            }
+            rows_read++;
+
+            // With early exit the pixel limits are checked as the rows are
+            // read, so that the rest of the tile is not waited for
+            crossed = early_exit && (max_error > thresholds.max_error ||
+                                     max_delta_e > thresholds.max_delta_e);
+          }
+          if (rows_read == 0) {
+            continue;
+          }
+
+          // The statistics only cover the rows read, a tile interrupted by
+          // another one is left skipped
+          const double pixels = static_cast<double>(rows_read) * tile1.cols;
+          double psnr = Psnr(sse, pixels * tile1.channels(), max_value);
+          bool interrupted = rows_read < tile1.rows && !crossed;
+          bool different = !interrupted &&
+                           (max_error > thresholds.max_error ||
+                            max_delta_e > thresholds.max_delta_e ||
+                            psnr < thresholds.min_psnr);
+
+          if (!interrupted) {
+            tiles.state.at<uint8_t>(tr, tc) = static_cast<uint8_t>(
+                different ? TileState::different : TileState::similar);
+          }
+          tiles.sse.at<double>(tr, tc) = sse;
+          tiles.psnr.at<double>(tr, tc) = psnr;
+          tiles.max_error.at<double>(tr, tc) = max_error;
+          if (kernel) {
+            tiles.delta_e.at<double>(tr, tc) = delta_e_sum / pixels;
+            tiles.max_delta_e.at<double>(tr, tc) = max_delta_e;
+          }
+
+          if (different) {
+            different_tiles++;
+            if (early_exit) {
+              stop = true;
+            }
+          }
+        }
+      });
+
+  tiles.different_tiles = different_tiles;
+  tiles.differ = different_tiles > 0;
+
+  return tiles;
+}
+}
@@ -0,0 +1,158 @@
+/** Interface file for computing image comparison metrics in a single pass
+ *
+ *  \file ipcv/utils/ImageMetrics.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    Psnr, Rmse and DeltaE each read both images, and each materializes
+ *    full-size temporaries (absolute differences, their float conversion,
+ *    L*a*b* images, the delta E map).  CompareImages computes all of the
+ *    metrics in one read of both images with per row block accumulators
+ *    (integer for integer sources), and writes a delta E map only when one
+ *    is requested.
+ *
+ *    CompareTiles reports the same statistics for every tile of a grid (a
+ *    heatmap of where the images differ).  Tiles are first checked for
+ *    byte equality (SIMD scans), identical tiles are not evaluated any
+ *    further.  In early-exit mode the comparison stops as soon as any tile
+ *    crosses a threshold.
+ */
+
+#pragma once
+
+#include <limits>
+#include <string>
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+struct ImageMetrics {
+  /// Sum of the squared errors over all pixels/channels
+  double sse = 0;
+
+  /// Mean squared error
+  double mse = 0;
+
+  /// Root mean squared error
+  double rmse = 0;
+
+  /// Peak signal-to-noise ratio [dB] (infinite for identical sources)
+  double psnr = 0;
+
+  /// Largest absolute error of any pixel/channel
+  double max_error = 0;
+
+  /// Mean delta E (0 when no delta E standard is requested)
+  double delta_e = 0;
+};
+
+/** Compare two source images
+ *
+ *  \param[in] src1         source cv::Mat
+ *  \param[in] src2         source cv::Mat of the same size and type as src1
+ *  \param[in] max_value    maximum possible value data sources may take on
+ *  \param[in] standard     delta E standard to use 0 (none) | 1976 | 1994 |
+ *                          2000, sources must be 3-channel BGR unless 0
+ *                          [default is 0]
+ *  \param[in] application  application type for the delta E 1994 standard
+ *                          graphic_arts | textiles
+ *                          [default is graphic_arts]
+ *  \param[out] dE          optional destination cv::Mat of CV_32FC1 for the
+ *                          delta E map (only filled in when not nullptr and
+ *                          a delta E standard is requested)
+ *  \param[in] grid         number of L*a*b* LUT grid nodes per BGR axis
+ *                          [default is 65]
+ *
+ *  Delta E is computed as by DeltaE, from L*a*b* values interpolated in a
+ *  LabLut: with the default grid every color lies within 0.15 delta E
+ *  (1976) of cv::cvtColor, and the delta E (2000) of a pair of colors
+ *  within 0.45 of DeltaE2000 on cv::cvtColor L*a*b* values (see DeltaE).
+ *
+ *  \return                 metrics between the sources
+ */
+ImageMetrics CompareImages(const cv::Mat& src1, const cv::Mat& src2,
+                           const int max_value, const int standard = 0,
+                           const std::string& application = "graphic_arts",
+                           cv::Mat* dE = nullptr, const int grid = 65);
+
+// Limits beyond which the images are considered different
+struct TileThresholds {
+  /// Largest absolute error of any pixel/channel allowed
+  double max_error = std::numeric_limits<double>::infinity();
+
+  /// Smallest tile PSNR [dB] allowed
+  double min_psnr = 0;
+
+  /// Largest delta E of any pixel allowed (only when a delta E standard is
+  /// requested)
+  double max_delta_e = std::numeric_limits<double>::infinity();
+};
+
+// State of a tile of a tile comparison
+enum class TileState {
+  skipped,    // not (fully) evaluated (early exit)
+  identical,  // byte-wise identical
+  similar,    // within the thresholds
+  different   // beyond at least one threshold
+};
+
+struct TileComparison {
+  /// True when any tile is beyond a threshold
+  bool differ = false;
+
+  /// Number of tiles beyond a threshold
+  int different_tiles = 0;
+
+  /// Per tile CV_8UC1 TileState values
+  cv::Mat state;
+
+  /// Per tile CV_64FC1 sum of the squared errors
+  cv::Mat sse;
+
+  /// Per tile CV_64FC1 PSNR [dB] (infinite for identical tiles)
+  cv::Mat psnr;
+
+  /// Per tile CV_64FC1 largest absolute error
+  cv::Mat max_error;
+
+  /// Per tile CV_64FC1 mean and largest delta E (empty when no delta E
+  /// standard is requested)
+  cv::Mat delta_e;
+  cv::Mat max_delta_e;
+};
+
+/** Compare two source images tile by tile
+ *
+ *  \param[in] src1         source cv::Mat
+ *  \param[in] src2         source cv::Mat of the same size and type as src1
+ *  \param[in] max_value    maximum possible value data sources may take on
+ *  \param[in] thresholds   limits beyond which a tile is different
+ *  \param[in] tile_size    tile width and height (tiles at the right and
+ *                          bottom edges may be smaller) [default is 64]
+ *  \param[in] early_exit   stop as soon as a tile is different (remaining
+ *                          tiles are left skipped, tiles being compared
+ *                          stop as well and are left skipped with
+ *                          statistics that cover only the rows read)
+ *                          [default is false]
+ *  \param[in] standard     delta E standard to use 0 (none) | 1976 | 1994 |
+ *                          2000, sources must be 3-channel BGR unless 0
+ *                          [default is 0]
+ *  \param[in] application  application type for the delta E 1994 standard
+ *                          graphic_arts | textiles
+ *                          [default is graphic_arts]
+ *  \param[in] grid         number of L*a*b* LUT grid nodes per BGR axis
+ *                          (see CompareImages) [default is 65]
+ *
+ *  \return                 per tile statistics of the comparison
+ */
+TileComparison CompareTiles(const cv::Mat& src1, const cv::Mat& src2,
+                            const int max_value,
+                            const TileThresholds& thresholds,
+                            const int tile_size = 64,
+                            const bool early_exit = false,
+                            const int standard = 0,
+                            const std::string& application = "graphic_arts",
+                            const int grid = 65);
+}
@@ -0,0 +1,191 @@
+/** Implementation file for converting BGR images to CIE L*a*b* through a 3-D
+ *  LUT
+ *
+ *  \file ipcv/utils/LabLut.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "LabLut.h"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+
+#include <opencv2/imgproc.hpp>
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+struct CachedNodes {
+  int grid;
+  cv::Mat nodes;
+};
+
+mutex cache_mutex;
+vector<CachedNodes> cache;
+
+// Exact L*a*b* values of the grid nodes, node (b, g, r) is stored at
+// (b * grid + g) * grid + r
+cv::Mat ComputeNodes(const int grid) {
+  cv::Mat bgr(1, grid * grid * grid, CV_32FC3);
+  cv::Vec3f* p = bgr.ptr<cv::Vec3f>(0);
+  for (int b = 0; b < grid; b++) {
+    for (int g = 0; g < grid; g++) {
+      for (int r = 0; r < grid; r++) {
+        *p++ = cv::Vec3f(b / static_cast<float>(grid - 1),
+                         g / static_cast<float>(grid - 1),
+                         r / static_cast<float>(grid - 1));
+      }
+    }
+  }
+  cv::Mat nodes;
+  cv::cvtColor(bgr, nodes, cv::COLOR_BGR2Lab);
+  return nodes;
+}
+
+cv::Mat CachedNodesFor(const int grid) {
+  lock_guard<mutex> lock(cache_mutex);
+  for (const auto& entry : cache) {
+    if (entry.grid == grid) {
+      return entry.nodes;
+    }
+  }
+  cv::Mat nodes = ComputeNodes(grid);
+  cache.push_back({grid, nodes});
+  return nodes;
+}
+
+// Trilinear interpolation within the cell whose lower corner is node
+inline cv::Vec3f Interpolate(const cv::Vec3f* nodes, const int grid,
+                             const int node, const float fb, const float fg,
+                             const float fr) {
+  const cv::Vec3f* n = nodes + node;
+  const int sg = grid;
+  const int sb = grid * grid;
+  cv::Vec3f value;
+  for (int k = 0; k < 3; k++) {
+    float c00 = n[0][k] + fr * (n[1][k] - n[0][k]);
+    float c01 = n[sg][k] + fr * (n[sg + 1][k] - n[sg][k]);
+    float c10 = n[sb][k] + fr * (n[sb + 1][k] - n[sb][k]);
+    float c11 = n[sb + sg][k] + fr * (n[sb + sg + 1][k] - n[sb + sg][k]);
+    float c0 = c00 + fg * (c01 - c00);
+    float c1 = c10 + fg * (c11 - c10);
+    value[k] = c0 + fb * (c1 - c0);
+  }
+  return value;
+}
+
+// Integer sources, the cell and position within the cell of every possible
+// value are tabulated
+template <typename T>
+void ConvertIntegerRow(const T* s, cv::Vec3f* lab, const int cols,
+                       const int step, const cv::Vec3f* nodes, const int grid,
+                       const int* lower, const float* fraction) {
+  for (int c = 0; c < cols; c++, s += 3 * step) {
+    int node = (lower[s[0]] * grid + lower[s[1]]) * grid + lower[s[2]];
+    lab[c] = Interpolate(nodes, grid, node, fraction[s[0]], fraction[s[1]],
+                         fraction[s[2]]);
+  }
+}
+
+void ConvertFloatRow(const float* s, cv::Vec3f* lab, const int cols,
+                     const int step, const cv::Vec3f* nodes, const int grid,
+                     const float scale) {
+  int lower[3];
+  float fraction[3];
+  for (int c = 0; c < cols; c++, s += 3 * step) {
+    for (int k = 0; k < 3; k++) {
+      float x = min(max(s[k] * scale, 0.0f), 1.0f) * (grid - 1);
+      lower[k] = min(static_cast<int>(x), grid - 2);
+      fraction[k] = x - lower[k];
+    }
+    int node = (lower[0] * grid + lower[1]) * grid + lower[2];
+    lab[c] = Interpolate(nodes, grid, node, fraction[0], fraction[1],
+                         fraction[2]);
+  }
+}
+}
+
+LabLut::LabLut(const int depth, const double max_value, const int grid)
+    : depth_(depth == CV_8U || depth == CV_16U ? depth : CV_32F),
+      grid_(grid),
+      scale_(static_cast<float>(1 / max_value)) {
+  if (grid < 2) {
+    cerr << "A L*a*b* LUT requires at least 2 grid nodes per axis" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (max_value <= 0) {
+    cerr << "Maximum value must be positive for L*a*b* conversion" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  nodes_ = CachedNodesFor(grid);
+
+  if (depth_ != CV_32F) {
+    const int values = depth_ == CV_8U ? 256 : 65536;
+    lower_.resize(values);
+    fraction_.resize(values);
+    for (int v = 0; v < values; v++) {
+      double x = min(v / max_value, 1.0) * (grid - 1);
+      lower_[v] = min(static_cast<int>(x), grid - 2);
+      fraction_[v] = static_cast<float>(x - lower_[v]);
+    }
+  }
+}
+
+void LabLut::ConvertRow(const cv::Mat& src, const int row, cv::Vec3f* lab,
+                        const int step) const {
+  const cv::Vec3f* nodes = nodes_.ptr<cv::Vec3f>(0);
+  const int cols = (src.cols + step - 1) / step;
+  switch (depth_) {
+    case CV_8U:
+      ConvertIntegerRow(src.ptr<uint8_t>(row), lab, cols, step, nodes, grid_,
+                        lower_.data(), fraction_.data());
+      break;
+    case CV_16U:
+      ConvertIntegerRow(src.ptr<uint16_t>(row), lab, cols, step, nodes, grid_,
+                        lower_.data(), fraction_.data());
+      break;
+    default:
+      if (src.depth() == CV_32F) {
+        ConvertFloatRow(src.ptr<float>(row), lab, cols, step, nodes, grid_,
+                        scale_);
+      } else {
+        cv::Mat converted;
+        src.row(row).convertTo(converted, CV_32F);
+        ConvertFloatRow(converted.ptr<float>(0), lab, cols, step, nodes,
+                        grid_, scale_);
+      }
+      break;
+  }
+}
+
+void LabLut::Convert(const cv::Mat& src, cv::Mat& lab) const {
+  if (src.channels() != 3) {
+    cerr << "Images must be 3-channel for L*a*b* conversion" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if (src.depth() != depth_ && depth_ != CV_32F) {
+    cerr << "Source depth does not match the L*a*b* LUT" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The destination may share the source data (in-place conversion)
+  cv::Mat dst(src.size(), CV_32FC3);
+  cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+    for (int r = range.start; r < range.end; r++) {
+      ConvertRow(src, r, dst.ptr<cv::Vec3f>(r));
+    }
+  });
+  lab = dst;
+}
+
+void BgrToLab(const cv::Mat& src, cv::Mat& lab, const double max_value) {
+  LabLut(src.depth(), max_value).Convert(src, lab);
+}
+}
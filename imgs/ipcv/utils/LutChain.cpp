@@ -0,0 +1,68 @@
+/** Implementation file for composing a chain of LUTs into a single LUT
+ *
+ *  \file ipcv/utils/LutChain.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "LutChain.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "imgs/ipcv/utils/ApplyLut.h"
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+// composed[b][v] = second[b][first[b][v]], a single row LUT is shared by
+// every channel
+template <typename T>
+cv::Mat Compose(const cv::Mat& first, const cv::Mat& second) {
+  const int rows = max(first.rows, second.rows);
+  cv::Mat composed(rows, first.cols, first.type());
+  for (int b = 0; b < rows; b++) {
+    const T* f = first.ptr<T>(first.rows == 1 ? 0 : b);
+    const T* s = second.ptr<T>(second.rows == 1 ? 0 : b);
+    T* c = composed.ptr<T>(b);
+    for (int v = 0; v < first.cols; v++) {
+      c[v] = s[f[v]];
+    }
+  }
+  return composed;
+}
+}
+
+LutChain& LutChain::Append(const cv::Mat& lut) {
+  bool valid = (lut.type() == CV_8UC1 && lut.cols == 256) ||
+               (lut.type() == CV_16UC1 && lut.cols == 65536);
+  if (valid && !lut_.empty()) {
+    valid = lut.type() == lut_.type() &&
+            (lut.rows == 1 || lut_.rows == 1 || lut.rows == lut_.rows);
+  }
+  if (!valid) {
+    cerr << "Incompatible LUT appended to the LUT chain" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if (lut_.empty()) {
+    lut_ = lut.clone();
+  } else if (lut_.depth() == CV_8U) {
+    lut_ = Compose<uint8_t>(lut_, lut);
+  } else {
+    lut_ = Compose<uint16_t>(lut_, lut);
+  }
+  return *this;
+}
+
+void LutChain::Apply(const cv::Mat& src, cv::Mat& dst) const {
+  if (lut_.empty()) {
+    src.copyTo(dst);
+    return;
+  }
+  ApplyLut(src, lut_, dst);
+}
+}
@@ -0,0 +1,55 @@
+/** Interface file for composing a chain of LUTs into a single LUT
+ *
+ *  \file ipcv/utils/LutChain.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    A sequence of point operations (e.g. a linear stretch, followed by
+ *    gamma correction, followed by a threshold) applied one after the
+ *    other costs one pass over the image per operation.  Composing their
+ *    LUTs first (lut[v] = lut_n[... lut_2[lut_1[v]]]) reduces the chain to
+ *    a single table and a single pass.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+class LutChain {
+ public:
+  /// An empty chain (the identity)
+  LutChain() = default;
+
+  /** Append a LUT to the end of the chain
+   *
+   *  \param[in] lut  LUT of CV_8UC1 (256 entries) or CV_16UC1 (65536
+   *                  entries) with one row per channel or a single row
+   *                  shared by all channels, of the same depth and
+   *                  compatible number of rows as the LUTs already in the
+   *                  chain
+   *
+   *  \return         the chain (so that calls may be chained)
+   */
+  LutChain& Append(const cv::Mat& lut);
+
+  /// True when no LUT has been appended
+  bool Empty() const { return lut_.empty(); }
+
+  /// The composed LUT (empty when the chain is empty)
+  const cv::Mat& Lut() const { return lut_; }
+
+  /** Apply the composed LUT to a source image (see ApplyLut)
+   *
+   *  \param[in] src   source cv::Mat of CV_8UC(n) or CV_16UC(n)
+   *  \param[out] dst  destination cv:Mat of the same type as src (a copy
+   *                   of src when the chain is empty)
+   */
+  void Apply(const cv::Mat& src, cv::Mat& dst) const;
+
+ private:
+  cv::Mat lut_;
+};
+}
@@ -7,10 +7,10 @@
 
 #include <iostream>
 
-#include <opencv2/imgproc.hpp>
-
 #include "Rmse.h"
 
+#include "imgs/ipcv/utils/ImageMetrics.h"
+
 using namespace std;
 
 namespace ipcv {
@@ -38,21 +38,8 @@ double Rmse(const cv::Mat& src1, const cv::Mat& src2) {
 //  }
 //  mse /= src1.rows * src1.cols * src1.channels();
 
-  // Compute the squared error at each pixel/channel location
-  cv::Mat se;
-  cv::absdiff(src1, src2, se);
-  se.convertTo(se, CV_32F);
-  cv::multiply(se, se, se); 
-
-  // Compute the sum of the squared errors across all pixels/channels
-  cv::Scalar channel_sse = cv::sum(se);
-  double sse = channel_sse.val[0] + channel_sse.val[1] + channel_sse.val[2];
-
-  // Compute the mean of the sum of the squared errors
-  double mse = sse / src1.rows / src1.cols / src1.channels();
-
-  // Compute the root of the mean of the sum of the squared errors
-  double rmse = sqrt(mse);
+  // Single pass over both sources, without full-size temporaries
+  double rmse = CompareImages(src1, src2, 1).rmse;
 
   return rmse;
 }
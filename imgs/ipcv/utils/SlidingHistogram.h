@@ -0,0 +1,147 @@
+/** Interface file for sliding-window (local) image histograms
+ *
+ *  \file ipcv/utils/SlidingHistogram.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    Constant-time sliding-window histograms after Perreault and Hebert,
+ *    "Median Filtering in Constant Time" (IEEE TIP, 2007).
+ *
+ *    One histogram is kept per image column, covering the 2 * radius + 1
+ *    rows of the window.  Moving down a row removes one pixel from and
+ *    adds one pixel to every column histogram.  Moving right along a row
+ *    adds the column histogram entering the window to the window
+ *    histogram and subtracts the one leaving it.  The cost per pixel is
+ *    therefore independent of the window radius.  A 16-bin coarse
+ *    histogram (high nibble) is maintained alongside the 256-bin
+ *    histogram so that quantiles are found by scanning at most 16 + 16
+ *    bins.
+ *
+ *    Image borders are handled by replicating the edge pixels, so every
+ *    window holds (2 * radius + 1)^2 counts.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+/// Largest supported window radius (the counts of a window must fit in 16
+/// bits)
+const int kMaxSlidingHistogramRadius = 127;
+
+/** Find the value of the provided rank in a sliding-window histogram
+ *
+ *  \param[in] histogram  256-bin window histogram
+ *  \param[in] coarse     16-bin coarse window histogram
+ *  \param[in] rank       0-based rank of the requested value (0 is the
+ *                        minimum, count - 1 is the maximum)
+ *
+ *  \return               the grey level of the requested rank
+ */
+inline int HistogramRank(const uint16_t* histogram, const uint16_t* coarse,
+                         int rank) {
+  int bin = 0;
+  while (bin < 15 && rank >= coarse[bin]) {
+    rank -= coarse[bin++];
+  }
+  int value = 16 * bin;
+  while (value < 255 && rank >= histogram[value]) {
+    rank -= histogram[value++];
+  }
+  return value;
+}
+
+/** Visit the sliding-window histogram of every pixel of an image
+ *
+ *  \param[in] src     source cv::Mat of CV_8UC1
+ *  \param[in] radius  window radius, the window is (2 * radius + 1)
+ *                     pixels square [0, kMaxSlidingHistogramRadius]
+ *  \param[in] visit   callable invoked in raster order as
+ *                       visit(row, col, histogram, coarse)
+ *                     with the 256-bin and 16-bin (uint16_t) histograms of
+ *                     the window centred on (row, col)
+ *
+ *  \return            a boolean indicating that the histograms were
+ *                     visited without error
+ */
+template <typename Visitor>
+bool SlidingHistogram(const cv::Mat& src, const int radius, Visitor&& visit) {
+  if (src.type() != CV_8UC1) {
+    std::cerr << "Sliding histogram requires a CV_8UC1 source image"
+              << std::endl;
+    return false;
+  }
+  if (radius < 0 || radius > kMaxSlidingHistogramRadius) {
+    std::cerr << "Sliding histogram radius must be in [0, "
+              << kMaxSlidingHistogramRadius << "]" << std::endl;
+    return false;
+  }
+
+  const int rows = src.rows;
+  const int cols = src.cols;
+  auto clamp_row = [rows](const int r) {
+    return std::min(std::max(r, 0), rows - 1);
+  };
+  auto clamp_col = [cols](const int c) {
+    return std::min(std::max(c, 0), cols - 1);
+  };
+
+  // Column histograms over the rows of the window
+  std::vector<uint16_t> columns(static_cast<size_t>(cols) * 256, 0);
+  std::vector<uint16_t> coarse_columns(static_cast<size_t>(cols) * 16, 0);
+  auto update_columns = [&](const int r, const int delta) {
+    const uint8_t* p = src.ptr<uint8_t>(clamp_row(r));
+    for (int c = 0; c < cols; c++) {
+      columns[c * 256 + p[c]] += delta;
+      coarse_columns[c * 16 + (p[c] >> 4)] += delta;
+    }
+  };
+
+  uint16_t histogram[256];
+  uint16_t coarse[16];
+  auto add = [&](const int c, const int sign) {
+    const uint16_t* column = &columns[clamp_col(c) * 256];
+    const uint16_t* coarse_column = &coarse_columns[clamp_col(c) * 16];
+    if (sign > 0) {
+      for (int i = 0; i < 256; i++) histogram[i] += column[i];
+      for (int i = 0; i < 16; i++) coarse[i] += coarse_column[i];
+    } else {
+      for (int i = 0; i < 256; i++) histogram[i] -= column[i];
+      for (int i = 0; i < 16; i++) coarse[i] -= coarse_column[i];
+    }
+  };
+
+  for (int r = -radius; r <= radius; r++) {
+    update_columns(r, 1);
+  }
+  for (int r = 0; r < rows; r++) {
+    if (r > 0) {
+      update_columns(r - radius - 1, -1);
+      update_columns(r + radius, 1);
+    }
+
+    std::fill(histogram, histogram + 256, 0);
+    std::fill(coarse, coarse + 16, 0);
+    for (int c = -radius; c <= radius; c++) {
+      add(c, 1);
+    }
+    for (int c = 0; c < cols; c++) {
+      if (c > 0) {
+        add(c + radius, 1);
+        add(c - radius - 1, -1);
+      }
+      visit(r, c, static_cast<const uint16_t*>(histogram),
+            static_cast<const uint16_t*>(coarse));
+    }
+  }
+  return true;
+}
+}
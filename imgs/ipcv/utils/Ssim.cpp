@@ -0,0 +1,334 @@
+/** Implementation file for computing the (multi-scale) structural similarity
+ *  between two images
+ *
+ *  \file ipcv/utils/Ssim.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "Ssim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+const double kK1 = 0.01;
+const double kK2 = 0.03;
+
+const int kGaussianSize = 11;
+const double kGaussianSigma = 1.5;
+const int kBoxSize = 8;
+
+// Scale weights of MS-SSIM (Wang, Simoncelli and Bovik, 2003)
+const int kScales = 5;
+const double kScaleWeights[kScales] = {0.0448, 0.2856, 0.3001, 0.2363,
+                                       0.1333};
+
+int WindowSize(const SsimWindow window) {
+  return window == SsimWindow::box ? kBoxSize : kGaussianSize;
+}
+
+// Sums over the windows of a plane of the SSIM and of its contrast-structure
+// term
+struct SsimSums {
+  double ssim = 0;
+  double cs = 0;
+};
+
+// SSIM and contrast-structure term of a window from its moments
+inline void WindowTerms(const double mean_x, const double mean_y,
+                        const double mean_xx, const double mean_yy,
+                        const double mean_xy, const double C1, const double C2,
+                        double& ssim, double& cs) {
+  double variance_x = mean_xx - mean_x * mean_x;
+  double variance_y = mean_yy - mean_y * mean_y;
+  double covariance = mean_xy - mean_x * mean_y;
+  cs = (2 * covariance + C2) / (variance_x + variance_y + C2);
+  ssim = (2 * mean_x * mean_y + C1) /
+         (mean_x * mean_x + mean_y * mean_y + C1) * cs;
+}
+
+// Separable Gaussian window, every band of output rows first sums its
+// window rows vertically (per column) and then slides along the columns
+SsimSums GaussianSsim(const cv::Mat& x, const cv::Mat& y, const double C1,
+                      const double C2, cv::Mat* ssim_map) {
+  const int size = kGaussianSize;
+  vector<double> weights(size);
+  double total = 0;
+  for (int k = 0; k < size; k++) {
+    double d = k - size / 2;
+    weights[k] = exp(-d * d / (2 * kGaussianSigma * kGaussianSigma));
+    total += weights[k];
+  }
+  for (auto& w : weights) {
+    w /= total;
+  }
+
+  const int rows = x.rows - size + 1;
+  const int cols = x.cols - size + 1;
+  SsimSums sums;
+  mutex sums_mutex;
+  cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& range) {
+    vector<double> vx(x.cols);
+    vector<double> vy(x.cols);
+    vector<double> vxx(x.cols);
+    vector<double> vyy(x.cols);
+    vector<double> vxy(x.cols);
+    SsimSums stripe;
+    for (int r = range.start; r < range.end; r++) {
+      fill(vx.begin(), vx.end(), 0.0);
+      fill(vy.begin(), vy.end(), 0.0);
+      fill(vxx.begin(), vxx.end(), 0.0);
+      fill(vyy.begin(), vyy.end(), 0.0);
+      fill(vxy.begin(), vxy.end(), 0.0);
+      for (int k = 0; k < size; k++) {
+        const float* px = x.ptr<float>(r + k);
+        const float* py = y.ptr<float>(r + k);
+        const double w = weights[k];
+        for (int c = 0; c < x.cols; c++) {
+          double a = px[c];
+          double b = py[c];
+          vx[c] += w * a;
+          vy[c] += w * b;
+          vxx[c] += w * a * a;
+          vyy[c] += w * b * b;
+          vxy[c] += w * a * b;
+        }
+      }
+
+      float* map = ssim_map ? ssim_map->ptr<float>(r) : nullptr;
+      for (int c = 0; c < cols; c++) {
+        double mean_x = 0;
+        double mean_y = 0;
+        double mean_xx = 0;
+        double mean_yy = 0;
+        double mean_xy = 0;
+        for (int k = 0; k < size; k++) {
+          const double w = weights[k];
+          mean_x += w * vx[c + k];
+          mean_y += w * vy[c + k];
+          mean_xx += w * vxx[c + k];
+          mean_yy += w * vyy[c + k];
+          mean_xy += w * vxy[c + k];
+        }
+        double ssim;
+        double cs;
+        WindowTerms(mean_x, mean_y, mean_xx, mean_yy, mean_xy, C1, C2, ssim,
+                    cs);
+        stripe.ssim += ssim;
+        stripe.cs += cs;
+        if (map) {
+          map[c] += static_cast<float>(ssim);
+        }
+      }
+    }
+    lock_guard<mutex> lock(sums_mutex);
+    sums.ssim += stripe.ssim;
+    sums.cs += stripe.cs;
+  });
+  return sums;
+}
+
+// Integral images (CV_64F, one row and column larger than the plane) of x,
+// y, x^2, y^2 and xy, rows are summed in parallel and then accumulated down
+// the columns in parallel column blocks
+void IntegralImages(const cv::Mat& x, const cv::Mat& y, cv::Mat integrals[5]) {
+  for (int q = 0; q < 5; q++) {
+    integrals[q] = cv::Mat::zeros(x.rows + 1, x.cols + 1, CV_64F);
+  }
+
+  cv::parallel_for_(cv::Range(0, x.rows), [&](const cv::Range& range) {
+    for (int r = range.start; r < range.end; r++) {
+      const float* px = x.ptr<float>(r);
+      const float* py = y.ptr<float>(r);
+      double* ix = integrals[0].ptr<double>(r + 1);
+      double* iy = integrals[1].ptr<double>(r + 1);
+      double* ixx = integrals[2].ptr<double>(r + 1);
+      double* iyy = integrals[3].ptr<double>(r + 1);
+      double* ixy = integrals[4].ptr<double>(r + 1);
+      for (int c = 0; c < x.cols; c++) {
+        double a = px[c];
+        double b = py[c];
+        ix[c + 1] = ix[c] + a;
+        iy[c + 1] = iy[c] + b;
+        ixx[c + 1] = ixx[c] + a * a;
+        iyy[c + 1] = iyy[c] + b * b;
+        ixy[c + 1] = ixy[c] + a * b;
+      }
+    }
+  });
+
+  cv::parallel_for_(cv::Range(0, x.cols + 1), [&](const cv::Range& range) {
+    for (int q = 0; q < 5; q++) {
+      for (int r = 1; r <= x.rows; r++) {
+        const double* above = integrals[q].ptr<double>(r - 1);
+        double* current = integrals[q].ptr<double>(r);
+        for (int c = range.start; c < range.end; c++) {
+          current[c] += above[c];
+        }
+      }
+    }
+  });
+}
+
+SsimSums BoxSsim(const cv::Mat& x, const cv::Mat& y, const double C1,
+                 const double C2, cv::Mat* ssim_map) {
+  const int size = kBoxSize;
+  cv::Mat integrals[5];
+  IntegralImages(x, y, integrals);
+
+  const int rows = x.rows - size + 1;
+  const int cols = x.cols - size + 1;
+  const double area = size * size;
+  SsimSums sums;
+  mutex sums_mutex;
+  cv::parallel_for_(cv::Range(0, rows), [&](const cv::Range& range) {
+    SsimSums stripe;
+    double means[5];
+    for (int r = range.start; r < range.end; r++) {
+      float* map = ssim_map ? ssim_map->ptr<float>(r) : nullptr;
+      for (int c = 0; c < cols; c++) {
+        for (int q = 0; q < 5; q++) {
+          const double* top = integrals[q].ptr<double>(r);
+          const double* bottom = integrals[q].ptr<double>(r + size);
+          means[q] =
+              (bottom[c + size] - bottom[c] - top[c + size] + top[c]) / area;
+        }
+        double ssim;
+        double cs;
+        WindowTerms(means[0], means[1], means[2], means[3], means[4], C1, C2,
+                    ssim, cs);
+        stripe.ssim += ssim;
+        stripe.cs += cs;
+        if (map) {
+          map[c] += static_cast<float>(ssim);
+        }
+      }
+    }
+    lock_guard<mutex> lock(sums_mutex);
+    sums.ssim += stripe.ssim;
+    sums.cs += stripe.cs;
+  });
+  return sums;
+}
+
+// Mean SSIM and contrast-structure term over the windows and planes
+void PlanesSsim(const vector<cv::Mat>& x, const vector<cv::Mat>& y,
+                const int max_value, const SsimWindow window, double& ssim,
+                double& cs, cv::Mat* ssim_map) {
+  const double C1 = (kK1 * max_value) * (kK1 * max_value);
+  const double C2 = (kK2 * max_value) * (kK2 * max_value);
+  const int size = WindowSize(window);
+  if (ssim_map) {
+    *ssim_map = cv::Mat::zeros(x[0].rows - size + 1, x[0].cols - size + 1,
+                               CV_32FC1);
+  }
+
+  ssim = 0;
+  cs = 0;
+  for (size_t p = 0; p < x.size(); p++) {
+    SsimSums sums = window == SsimWindow::box
+                        ? BoxSsim(x[p], y[p], C1, C2, ssim_map)
+                        : GaussianSsim(x[p], y[p], C1, C2, ssim_map);
+    ssim += sums.ssim;
+    cs += sums.cs;
+  }
+  const double windows = static_cast<double>(x[0].rows - size + 1) *
+                         (x[0].cols - size + 1) * x.size();
+  ssim /= windows;
+  cs /= windows;
+  if (ssim_map) {
+    *ssim_map /= static_cast<double>(x.size());
+  }
+}
+
+// Single precision planes of a source image
+vector<cv::Mat> Planes(const cv::Mat& src) {
+  vector<cv::Mat> planes(src.channels());
+  cv::split(src, planes.data());
+  for (auto& plane : planes) {
+    plane.convertTo(plane, CV_32F);
+  }
+  return planes;
+}
+
+// 2 x 2 average followed by downsampling by 2
+cv::Mat Downsample(const cv::Mat& plane) {
+  cv::Mat dst(plane.rows / 2, plane.cols / 2, CV_32F);
+  cv::parallel_for_(cv::Range(0, dst.rows), [&](const cv::Range& range) {
+    for (int r = range.start; r < range.end; r++) {
+      const float* s0 = plane.ptr<float>(2 * r);
+      const float* s1 = plane.ptr<float>(2 * r + 1);
+      float* d = dst.ptr<float>(r);
+      for (int c = 0; c < dst.cols; c++) {
+        d[c] = (s0[2 * c] + s0[2 * c + 1] + s1[2 * c] + s1[2 * c + 1]) / 4;
+      }
+    }
+  });
+  return dst;
+}
+
+void CheckSources(const cv::Mat& src1, const cv::Mat& src2,
+                  const int min_size) {
+  if (src1.size() != src2.size() || src1.type() != src2.type()) {
+    cerr << "Image dimensions and types must match exactly for SSIM "
+         << "computation" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (src1.channels() < 1 || src1.channels() > 4) {
+    cerr << "Images must have 1 to 4 channels for SSIM computation" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (src1.rows < min_size || src1.cols < min_size) {
+    cerr << "Images must be at least " << min_size << " x " << min_size
+         << " for SSIM computation" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+}
+
+double Ssim(const cv::Mat& src1, const cv::Mat& src2, const int max_value,
+            cv::Mat* ssim_map, const SsimWindow window) {
+  CheckSources(src1, src2, WindowSize(window));
+
+  double ssim;
+  double cs;
+  PlanesSsim(Planes(src1), Planes(src2), max_value, window, ssim, cs,
+             ssim_map);
+
+  return ssim;
+}
+
+double MsSsim(const cv::Mat& src1, const cv::Mat& src2, const int max_value,
+              const SsimWindow window) {
+  CheckSources(src1, src2, WindowSize(window) << (kScales - 1));
+
+  vector<cv::Mat> x = Planes(src1);
+  vector<cv::Mat> y = Planes(src2);
+  double msssim = 1;
+  for (int scale = 0; scale < kScales; scale++) {
+    double ssim;
+    double cs;
+    PlanesSsim(x, y, max_value, window, ssim, cs, nullptr);
+    double term = scale == kScales - 1 ? ssim : cs;
+    msssim *= pow(max(term, 0.0), kScaleWeights[scale]);
+
+    if (scale < kScales - 1) {
+      for (size_t p = 0; p < x.size(); p++) {
+        x[p] = Downsample(x[p]);
+        y[p] = Downsample(y[p]);
+      }
+    }
+  }
+
+  return msssim;
+}
+}
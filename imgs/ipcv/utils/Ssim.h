@@ -0,0 +1,66 @@
+/** Interface file for computing the (multi-scale) structural similarity
+ *  between two images
+ *
+ *  \file ipcv/utils/Ssim.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    SSIM (Wang et al., 2004) compares local means, variances and the
+ *    covariance of the sources within a sliding window.  The windowed
+ *    moments are either computed with a separable 11 x 11 Gaussian window
+ *    (sigma 1.5), or with an 8 x 8 box window from integral images of x,
+ *    y, x^2, y^2 and xy.  Both run in time linear in the number of pixels,
+ *    with bands of rows processed in parallel.  Only windows that lie
+ *    entirely within the image are evaluated, multiple channels are
+ *    averaged.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+// Available SSIM windows
+enum class SsimWindow {
+  gaussian,  // 11 x 11 Gaussian, sigma 1.5
+  box        // 8 x 8 box (integral images)
+};
+
+/** Compute the structural similarity between the provided source images
+ *
+ *  \param[in] src1        source cv::Mat of 1 to 4 channels
+ *  \param[in] src2        source cv::Mat of the same size and type as src1
+ *  \param[in] max_value   maximum possible value data sources may take on
+ *  \param[out] ssim_map   optional destination cv::Mat of CV_32FC1 for the
+ *                         SSIM of every window (averaged over channels, of
+ *                         size src.rows - window + 1 x src.cols - window +
+ *                         1) [default is nullptr]
+ *  \param[in] window      window type [default is SsimWindow::gaussian]
+ *
+ *  \return                scalar containing mean SSIM between sources
+ */
+double Ssim(const cv::Mat& src1, const cv::Mat& src2, const int max_value,
+            cv::Mat* ssim_map = nullptr,
+            const SsimWindow window = SsimWindow::gaussian);
+
+/** Compute the multi-scale structural similarity between the provided
+ *  source images
+ *
+ *  The contrast-structure terms of the first four of five dyadic scales
+ *  (2 x 2 averaging between scales) and the SSIM of the coarsest scale are
+ *  combined with the weights of Wang et al. (2003).  Negative terms are
+ *  clipped to zero.  The coarsest scale must still hold a window, i.e. the
+ *  sources must be at least 16 windows wide and high.
+ *
+ *  \param[in] src1        source cv::Mat of 1 to 4 channels
+ *  \param[in] src2        source cv::Mat of the same size and type as src1
+ *  \param[in] max_value   maximum possible value data sources may take on
+ *  \param[in] window      window type [default is SsimWindow::gaussian]
+ *
+ *  \return                scalar containing MS-SSIM between sources
+ */
+double MsSsim(const cv::Mat& src1, const cv::Mat& src2, const int max_value,
+              const SsimWindow window = SsimWindow::gaussian);
+}
@@ -19,6 +19,12 @@
 #include "imgs/ipcv/utils/Histogram.h"
 #include "imgs/ipcv/utils/HistogramToPdf.h"
 #include "imgs/ipcv/utils/HistogramToCdf.h"
+#include "imgs/ipcv/utils/ImageMetrics.h"
 #include "imgs/ipcv/utils/Indices.h"
+#include "imgs/ipcv/utils/LabLut.h"
+#include "imgs/ipcv/utils/LutChain.h"
 #include "imgs/ipcv/utils/Psnr.h"
 #include "imgs/ipcv/utils/Rmse.h"
+#include "imgs/ipcv/utils/SlidingHistogram.h"
+#include "imgs/ipcv/utils/Ssim.h"
+#include "imgs/ipcv/utils/WhiteBalance.h"
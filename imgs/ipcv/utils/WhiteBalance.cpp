@@ -0,0 +1,230 @@
+/** Implementation file for estimating the scene illuminant and white
+ *  balancing images with a diagonal (von Kries) correction
+ *
+ *  \file ipcv/utils/WhiteBalance.cpp
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ */
+
+#include "WhiteBalance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#include "imgs/ipcv/utils/ApplyLut.h"
+
+using namespace std;
+
+namespace ipcv {
+
+namespace {
+
+void CheckSource(const cv::Mat& src, const int max_value) {
+  if (src.type() != CV_8UC3 && src.type() != CV_16UC3) {
+    cerr << "Source image must be of either type CV_8UC3 or CV_16UC3 for "
+         << "white balancing" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (max_value <= 0) {
+    cerr << "Maximum value must be positive for white balancing" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+// Statistics of a band of rows, merged into the totals at the end
+struct Partial {
+  double count = 0;
+  cv::Vec3d sum;
+  cv::Vec3d maximum;
+  cv::Vec3d power_sum;
+  cv::Vec3d edge_power_sum;
+  vector<int> histogram;
+};
+
+// Accumulate the statistics of sampled rows [r0, r1), power holds
+// (value / max_value)^p of every possible value
+template <typename T>
+void Accumulate(const cv::Mat& src, const int r0, const int r1,
+                const int stride, const int bins, const double max_value,
+                const double p, const double* power, Partial& partial) {
+  const double normalization = 1 / (max_value * max_value);
+  for (int i = r0; i < r1; i++) {
+    const int r = i * stride;
+    const T* s = src.ptr<T>(r);
+    const T* below = src.ptr<T>(min(r + 1, src.rows - 1));
+    for (int c = 0; c < src.cols; c += stride) {
+      const int right = 3 * min(c + 1, src.cols - 1);
+      for (int k = 0; k < 3; k++) {
+        const int v = s[3 * c + k];
+        partial.sum[k] += v;
+        partial.maximum[k] = max(partial.maximum[k], static_cast<double>(v));
+        partial.power_sum[k] += power[v];
+        partial.histogram[k * bins + v]++;
+
+        // Flat regions do not contribute to the gray edge norm, the power
+        // is only evaluated for nonzero gradients
+        const double dx = s[right + k] - v;
+        const double dy = below[3 * c + k] - v;
+        const double magnitude = (dx * dx + dy * dy) * normalization;
+        if (magnitude > 0) {
+          partial.edge_power_sum[k] += pow(magnitude, p / 2);
+        }
+      }
+      partial.count++;
+    }
+  }
+}
+
+template <typename T>
+AwbStatistics Compute(const cv::Mat& src, const int max_value, const double p,
+                      const int stride) {
+  const int bins = 1 << (8 * sizeof(T));
+  vector<double> power(bins);
+  for (int v = 0; v < bins; v++) {
+    power[v] = pow(static_cast<double>(v) / max_value, p);
+  }
+
+  AwbStatistics statistics;
+  statistics.max_value = max_value;
+  statistics.p = p;
+  statistics.histogram = cv::Mat_<int>::zeros(3, bins);
+  int* total = statistics.histogram.ptr<int>(0);
+  mutex total_mutex;
+
+  // One band per thread keeps the number of private (16-bit) histograms
+  // down
+  const int rows = (src.rows + stride - 1) / stride;
+  const int stripes = min(rows, max(cv::getNumThreads(), 1));
+  cv::parallel_for_(
+      cv::Range(0, rows),
+      [&](const cv::Range& range) {
+        Partial partial;
+        partial.histogram.assign(3 * bins, 0);
+        Accumulate<T>(src, range.start, range.end, stride, bins, max_value,
+                      p, power.data(), partial);
+
+        lock_guard<mutex> lock(total_mutex);
+        statistics.count += partial.count;
+        for (int k = 0; k < 3; k++) {
+          statistics.sum[k] += partial.sum[k];
+          statistics.maximum[k] =
+              max(statistics.maximum[k], partial.maximum[k]);
+          statistics.power_sum[k] += partial.power_sum[k];
+          statistics.edge_power_sum[k] += partial.edge_power_sum[k];
+        }
+        for (int i = 0; i < 3 * bins; i++) {
+          total[i] += partial.histogram[i];
+        }
+      },
+      stripes);
+
+  return statistics;
+}
+
+// Gains applied to a channel through a LUT, values are clipped to max_value
+template <typename T>
+cv::Mat GainLut(const cv::Vec3d& gains, const int max_value) {
+  const int bins = 1 << (8 * sizeof(T));
+  cv::Mat lut(3, bins, sizeof(T) == 1 ? CV_8UC1 : CV_16UC1);
+  for (int k = 0; k < 3; k++) {
+    T* table = lut.ptr<T>(k);
+    for (int v = 0; v < bins; v++) {
+      double value = min(v * gains[k], static_cast<double>(max_value));
+      table[v] = cv::saturate_cast<T>(value);
+    }
+  }
+  return lut;
+}
+}
+
+AwbStatistics AccumulateAwbStatistics(const cv::Mat& src, const int max_value,
+                                      const double p, const int stride) {
+  CheckSource(src, max_value);
+  if (p <= 0) {
+    cerr << "Minkowski norm must be positive for white balancing" << endl;
+    exit(EXIT_FAILURE);
+  }
+  if (stride < 1) {
+    cerr << "Subsampling stride must be positive" << endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if (src.depth() == CV_8U) {
+    return Compute<uint8_t>(src, max_value, p, stride);
+  }
+  return Compute<uint16_t>(src, max_value, p, stride);
+}
+
+cv::Vec3d EstimateIlluminant(const AwbStatistics& statistics,
+                             const AwbEstimator estimator,
+                             const double percentile) {
+  cv::Vec3d illuminant;
+  if (statistics.count == 0) {
+    return illuminant;
+  }
+
+  for (int k = 0; k < 3; k++) {
+    switch (estimator) {
+      case AwbEstimator::gray_world:
+        illuminant[k] = statistics.sum[k] / statistics.count;
+        break;
+      case AwbEstimator::white_patch:
+        illuminant[k] = statistics.maximum[k];
+        break;
+      case AwbEstimator::shades_of_gray:
+        illuminant[k] = statistics.max_value *
+                        pow(statistics.power_sum[k] / statistics.count,
+                            1 / statistics.p);
+        break;
+      case AwbEstimator::gray_edge:
+        illuminant[k] = statistics.max_value *
+                        pow(statistics.edge_power_sum[k] / statistics.count,
+                            1 / statistics.p);
+        break;
+      case AwbEstimator::percentile: {
+        // Smallest value with at least the percentile of the samples at or
+        // below it
+        const int* h = statistics.histogram.ptr<int>(k);
+        const double target =
+            min(max(percentile, 0.0), 100.0) / 100 * statistics.count;
+        double cumulative = 0;
+        int v = 0;
+        for (; v < statistics.histogram.cols - 1; v++) {
+          cumulative += h[v];
+          if (cumulative >= target && cumulative > 0) {
+            break;
+          }
+        }
+        illuminant[k] = v;
+        break;
+      }
+    }
+  }
+
+  return illuminant;
+}
+
+cv::Mat WhiteBalance(const cv::Mat& src, const cv::Vec3d& illuminant,
+                     const int max_value) {
+  CheckSource(src, max_value);
+
+  cv::Vec3d gains(1, 1, 1);
+  for (int k = 0; k < 3; k++) {
+    if (illuminant[k] > 0 && illuminant[1] > 0) {
+      gains[k] = illuminant[1] / illuminant[k];
+    }
+  }
+
+  cv::Mat dst;
+  if (src.depth() == CV_8U) {
+    ApplyLut(src, GainLut<uint8_t>(gains, max_value), dst);
+  } else {
+    ApplyLut(src, GainLut<uint16_t>(gains, max_value), dst);
+  }
+
+  return dst;
+}
+}
@@ -0,0 +1,110 @@
+/** Interface file for estimating the scene illuminant and white balancing
+ *  images with a diagonal (von Kries) correction
+ *
+ *  \file ipcv/utils/WhiteBalance.h
+ *  \author Jacob Stevens (jss8649@rit.edu)
+ *  \date 19 Oct 2026
+ *
+ *  \description
+ *    Gray world fails on scenes dominated by a single color.  The
+ *    estimators here make different assumptions about the scene: white
+ *    patch (the brightest value of every channel is white), shades of gray
+ *    (the Minkowski p-norm of the image is gray), gray edge (the p-norm of
+ *    the gradient magnitude is gray) and a percentile-clipped white patch
+ *    that ignores specular highlights and hot pixels.
+ *
+ *    All of the estimators are derived from the statistics of a single
+ *    multithreaded read of the image (per-channel sums, maxima, p-power
+ *    sums, gradient p-power sums and histograms), so that any number of
+ *    them may be evaluated for the cost of one pass.
+ */
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+namespace ipcv {
+
+// Available illuminant estimators
+enum class AwbEstimator {
+  gray_world,      // per-channel mean
+  white_patch,     // per-channel maximum
+  shades_of_gray,  // per-channel Minkowski p-norm
+  gray_edge,       // per-channel Minkowski p-norm of the gradient magnitude
+  percentile       // per-channel percentile (clipped white patch)
+};
+
+struct AwbStatistics {
+  /// Maximum possible value data sources may take on
+  int max_value = 255;
+
+  /// Minkowski norm of the p-power sums
+  double p = 6;
+
+  /// Number of pixels sampled
+  double count = 0;
+
+  /// Per-channel (BGR) sum of the sampled values
+  cv::Vec3d sum;
+
+  /// Per-channel largest sampled value
+  cv::Vec3d maximum;
+
+  /// Per-channel sum of (value / max_value)^p
+  cv::Vec3d power_sum;
+
+  /// Per-channel sum of (gradient magnitude / max_value)^p, forward
+  /// differences to the right and below every sampled pixel
+  cv::Vec3d edge_power_sum;
+
+  /// Per-channel histogram of the sampled values, a cv::Mat of CV_32SC1
+  /// with one row per channel and 256 (8-bit) or 65536 (16-bit) columns
+  cv::Mat histogram;
+};
+
+/** Accumulate the statistics of all illuminant estimators in one pass
+ *
+ *  \param[in] src         source cv::Mat of CV_8UC3 or CV_16UC3
+ *  \param[in] max_value   maximum possible value data sources may take on
+ *                         [default is 255]
+ *  \param[in] p           Minkowski norm of the shades of gray and gray
+ *                         edge estimators [default is 6]
+ *  \param[in] stride      only every stride-th pixel of every stride-th row
+ *                         is sampled [default is 1]
+ *
+ *  \return                accumulated statistics
+ */
+AwbStatistics AccumulateAwbStatistics(const cv::Mat& src,
+                                      const int max_value = 255,
+                                      const double p = 6,
+                                      const int stride = 1);
+
+/** Estimate the scene illuminant from accumulated statistics
+ *
+ *  \param[in] statistics  statistics from AccumulateAwbStatistics
+ *  \param[in] estimator   illuminant estimator
+ *  \param[in] percentile  percentile [0, 100] of the percentile estimator
+ *                         [default is 99]
+ *
+ *  \return                BGR illuminant in the units of the source
+ */
+cv::Vec3d EstimateIlluminant(const AwbStatistics& statistics,
+                             const AwbEstimator estimator,
+                             const double percentile = 99);
+
+/** White balance a source image for an illuminant
+ *
+ *  The blue and red channels are scaled so that the illuminant becomes
+ *  neutral at its green level (channels of a zero illuminant are left
+ *  unchanged), values are clipped to max_value.
+ *
+ *  \param[in] src         source cv::Mat of CV_8UC3 or CV_16UC3
+ *  \param[in] illuminant  BGR illuminant (see EstimateIlluminant)
+ *  \param[in] max_value   maximum possible value data sources may take on
+ *                         [default is 255]
+ *
+ *  \return                white balanced source image
+ */
+cv::Mat WhiteBalance(const cv::Mat& src, const cv::Vec3d& illuminant,
+                     const int max_value = 255);
+}